@@ -0,0 +1,64 @@
+#ifndef H_CACHE_IO
+#define H_CACHE_IO
+
+#include <string>
+#include <fstream>
+#include <stdint.h>
+
+//Pieces shared by the small caches the jobs keep on disk (file manifests, the
+//normalization catalog, 3D pileup weights): the hash used to key them, and a
+//writer that only ever puts complete files in place.
+
+//64 bit FNV-1a
+class CacheHash{
+public:
+  CacheHash();
+
+  void Add(const void* data, const std::size_t size);
+  void Add(const std::string& text);
+  void AddByte(const unsigned char byte);
+
+  uint64_t Get() const;
+
+private:
+  uint64_t hash_;
+};
+
+//Writes to a temporary file next to file_name, named after the process, and
+//renames it into place on Commit(). Concurrent jobs therefore read either the
+//old or the new file; without a successful Commit() the temporary is removed.
+class AtomicFileWriter{
+public:
+  explicit AtomicFileWriter(const std::string& file_name);
+  ~AtomicFileWriter();
+
+  std::ofstream& GetStream();
+  bool Commit();
+
+private:
+  AtomicFileWriter(const AtomicFileWriter&);
+  AtomicFileWriter& operator=(const AtomicFileWriter&);
+
+  std::string file_name_, temp_name_;
+  std::ofstream stream_;
+  bool committed_;
+};
+
+//Exclusive flock on lock_name, created if needed, held until destruction. Taken
+//around a read-modify-write of a shared file: renaming the new version into
+//place keeps readers safe, but two writers would each drop the other's changes.
+class FileLock{
+public:
+  explicit FileLock(const std::string& lock_name);
+  ~FileLock();
+
+  bool IsLocked() const;
+
+private:
+  FileLock(const FileLock&);
+  FileLock& operator=(const FileLock&);
+
+  int fd_;
+};
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef H_CFA_BRANCH_VISITOR
+#define H_CFA_BRANCH_VISITOR
+
+#include <vector>
+#include <string>
+
+//Interface handed to cfA::VisitBranches, which calls Visit once for every branch
+//member of the generated cfA class. One overload per branch type found in cfA ntuples.
+class CfaBranchVisitor{
+public:
+  virtual ~CfaBranchVisitor();
+
+  virtual void Visit(const std::string&, bool&)=0;
+  virtual void Visit(const std::string&, int&)=0;
+  virtual void Visit(const std::string&, unsigned&)=0;
+  virtual void Visit(const std::string&, float&)=0;
+  virtual void Visit(const std::string&, double&)=0;
+  virtual void Visit(const std::string&, std::string*&)=0;
+  virtual void Visit(const std::string&, std::vector<bool>*&)=0;
+  virtual void Visit(const std::string&, std::vector<int>*&)=0;
+  virtual void Visit(const std::string&, std::vector<float>*&)=0;
+  virtual void Visit(const std::string&, std::vector<std::string>*&)=0;
+  virtual void Visit(const std::string&, std::vector<std::vector<int> >*&)=0;
+  virtual void Visit(const std::string&, std::vector<std::vector<float> >*&)=0;
+  virtual void Visit(const std::string&, std::vector<std::vector<std::string> >*&)=0;
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef H_CFA_CACHE
+#define H_CFA_CACHE
+
+#include <vector>
+#include <string>
+#include <set>
+#include <stdint.h>
+#include "cfa_branch_visitor.hpp"
+#include "columnar_file.hpp"
+
+//Local columnar copy of the cfA branches used by the analysis. CfaCacheWriter is
+//bound to the members of a cfA object reading the original ntuples and writes one
+//column per selected branch; CfaCacheReader binds the same members to the columns
+//of a memory-mapped cache so that EventHandler can run on the cache unchanged.
+
+class CfaCacheBinding{
+public:
+  virtual ~CfaCacheBinding();
+  virtual void Write(ColumnarWriter&)=0;
+  virtual uint64_t Read(const uint64_t)=0;
+};
+
+bool IsCfaCacheFile(const std::string& file_name);
+
+class CfaCacheWriter : public CfaBranchVisitor{
+public:
+  CfaCacheWriter(const std::string& path, const std::set<std::string>& branches);
+  ~CfaCacheWriter();
+
+  bool IsOpen() const;
+  const std::vector<std::string>& GetBoundBranches() const;
+
+  void Fill();
+  void SetMetadata(const std::string& key, const std::string& value);
+  bool Close();
+  uint64_t GetBytesWritten() const;
+
+  void Visit(const std::string&, bool&);
+  void Visit(const std::string&, int&);
+  void Visit(const std::string&, unsigned&);
+  void Visit(const std::string&, float&);
+  void Visit(const std::string&, double&);
+  void Visit(const std::string&, std::string*&);
+  void Visit(const std::string&, std::vector<bool>*&);
+  void Visit(const std::string&, std::vector<int>*&);
+  void Visit(const std::string&, std::vector<float>*&);
+  void Visit(const std::string&, std::vector<std::string>*&);
+  void Visit(const std::string&, std::vector<std::vector<int> >*&);
+  void Visit(const std::string&, std::vector<std::vector<float> >*&);
+  void Visit(const std::string&, std::vector<std::vector<std::string> >*&);
+
+private:
+  CfaCacheWriter(const CfaCacheWriter&);
+  CfaCacheWriter& operator=(const CfaCacheWriter&);
+
+  ColumnarWriter writer_;
+  std::set<std::string> branches_;
+  std::vector<std::string> bound_branches_;
+  std::vector<CfaCacheBinding*> bindings_;
+
+  template<typename T> void Bind(const std::string& name, T& member);
+};
+
+class CfaCacheReader : public CfaBranchVisitor{
+public:
+  explicit CfaCacheReader(const std::string& path);
+  ~CfaCacheReader();
+
+  bool IsOpen() const;
+  int GetNumEntries() const;
+  std::string GetSampleName() const;
+  const ColumnarFile& GetFile() const;
+  //False if any branch visited so far is missing from the cache or has the wrong
+  //type, i.e. the cache was made for a different cfA class
+  bool IsComplete() const;
+  const std::vector<std::string>& GetMissingBranches() const;
+
+  int GetEntry(const unsigned int entry);
+
+  void Visit(const std::string&, bool&);
+  void Visit(const std::string&, int&);
+  void Visit(const std::string&, unsigned&);
+  void Visit(const std::string&, float&);
+  void Visit(const std::string&, double&);
+  void Visit(const std::string&, std::string*&);
+  void Visit(const std::string&, std::vector<bool>*&);
+  void Visit(const std::string&, std::vector<int>*&);
+  void Visit(const std::string&, std::vector<float>*&);
+  void Visit(const std::string&, std::vector<std::string>*&);
+  void Visit(const std::string&, std::vector<std::vector<int> >*&);
+  void Visit(const std::string&, std::vector<std::vector<float> >*&);
+  void Visit(const std::string&, std::vector<std::vector<std::string> >*&);
+
+private:
+  CfaCacheReader(const CfaCacheReader&);
+  CfaCacheReader& operator=(const CfaCacheReader&);
+
+  ColumnarFile file_;
+  std::set<std::string> branches_;
+  std::vector<std::string> missing_branches_;
+  std::vector<CfaCacheBinding*> bindings_;
+
+  template<typename T> void Bind(const std::string& name, T& member);
+};
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef H_CFA_CACHE_MAKER
+#define H_CFA_CACHE_MAKER
+
+#include <string>
+#include <set>
+#include "cfa.hpp"
+
+class CfaCacheMaker : public cfA{
+public:
+  CfaCacheMaker(const std::string& in_file_name,
+                const bool is_list);
+
+  bool MakeCache(const std::string& out_file_name,
+                 const std::set<std::string>& branches);
+
+  std::set<std::string> GetDefaultBranches();
+  static std::set<std::string> ReadBranchList(const std::string& file_name);
+};
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef H_COLUMNAR_FILE
+#define H_COLUMNAR_FILE
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <map>
+#include <stdint.h>
+
+//Simple uncompressed column store. Each column holds the leaf values of one
+//branch back to back, with one array of uint64_t offsets per level of nesting
+//(a std::vector<float> branch has depth 1, std::vector<std::vector<float> > has
+//depth 2, a std::string is stored as a depth 1 list of chars). Every array starts
+//on a 64 byte boundary so that the file can be mapped into memory and used in place.
+
+enum ColumnType{
+  kColumnBool=0,
+  kColumnChar=1,
+  kColumnUInt8=2,
+  kColumnInt16=3,
+  kColumnUInt16=4,
+  kColumnInt32=5,
+  kColumnUInt32=6,
+  kColumnFloat=7,
+  kColumnDouble=8
+};
+
+size_t GetColumnTypeSize(const ColumnType type);
+
+template<typename T> struct ColumnTraits;
+template<> struct ColumnTraits<bool>{static const ColumnType type=kColumnBool; static const unsigned depth=0;};
+template<> struct ColumnTraits<char>{static const ColumnType type=kColumnChar; static const unsigned depth=0;};
+template<> struct ColumnTraits<uint8_t>{static const ColumnType type=kColumnUInt8; static const unsigned depth=0;};
+template<> struct ColumnTraits<int16_t>{static const ColumnType type=kColumnInt16; static const unsigned depth=0;};
+template<> struct ColumnTraits<uint16_t>{static const ColumnType type=kColumnUInt16; static const unsigned depth=0;};
+template<> struct ColumnTraits<int32_t>{static const ColumnType type=kColumnInt32; static const unsigned depth=0;};
+template<> struct ColumnTraits<uint32_t>{static const ColumnType type=kColumnUInt32; static const unsigned depth=0;};
+template<> struct ColumnTraits<float>{static const ColumnType type=kColumnFloat; static const unsigned depth=0;};
+template<> struct ColumnTraits<double>{static const ColumnType type=kColumnDouble; static const unsigned depth=0;};
+template<> struct ColumnTraits<std::string>{static const ColumnType type=kColumnChar; static const unsigned depth=1;};
+template<typename T> struct ColumnTraits<std::vector<T> >{
+  static const ColumnType type=ColumnTraits<T>::type;
+  static const unsigned depth=ColumnTraits<T>::depth+1;
+};
+template<typename T> struct ColumnTraits<T*>{
+  static const ColumnType type=ColumnTraits<T>::type;
+  static const unsigned depth=ColumnTraits<T>::depth;
+};
+
+template<typename T>
+struct ColumnSpan{
+  ColumnSpan():
+    data(NULL),
+    size(0){
+  }
+  ColumnSpan(const T* data_in, const uint64_t size_in):
+    data(data_in),
+    size(size_in){
+  }
+
+  bool IsValid() const{return data!=NULL;}
+  const T& operator[](const uint64_t i) const{return data[i];}
+  const T* begin() const{return data;}
+  const T* end() const{return data+size;}
+
+  const T* data;
+  uint64_t size;
+};
+
+struct ColumnarColumn{
+  static const unsigned max_depth=3;
+
+  std::string name;
+  ColumnType type;
+  unsigned depth;
+  uint64_t num_values;
+  const void* values;
+  uint64_t num_offsets[max_depth];
+  const uint64_t* offsets[max_depth];
+};
+
+class ColumnarWriter{
+public:
+  explicit ColumnarWriter(const std::string& path);
+  ~ColumnarWriter();
+
+  bool IsOpen() const;
+
+  unsigned AddColumn(const std::string& name, const ColumnType type, const unsigned depth=0);
+  void SetMetadata(const std::string& key, const std::string& value);
+
+  void Append(const unsigned column, const void* values, const uint64_t num_values);
+  void EndList(const unsigned column, const unsigned level);
+  void EndEntry();
+
+  uint64_t GetNumEntries() const;
+  uint64_t GetBytesWritten() const;
+
+  bool Close();
+
+private:
+  struct Stream{
+    FILE* file;
+    uint64_t count;
+  };
+  struct PendingColumn{
+    std::string name;
+    ColumnType type;
+    unsigned depth;
+    Stream values;
+    Stream offsets[ColumnarColumn::max_depth];
+  };
+
+  ColumnarWriter(const ColumnarWriter&);
+  ColumnarWriter& operator=(const ColumnarWriter&);
+
+  std::string path_;
+  std::vector<PendingColumn> columns_;
+  std::map<std::string, std::string> metadata_;
+  uint64_t num_entries_, bytes_written_;
+  bool open_, good_;
+
+  void WriteOffset(Stream& stream, const uint64_t offset);
+  void CloseStreams();
+};
+
+class ColumnarFile{
+public:
+  explicit ColumnarFile(const std::string& path);
+  ~ColumnarFile();
+
+  bool IsOpen() const;
+
+  uint64_t GetNumEntries() const;
+  uint64_t GetFileSize() const;
+  const std::vector<ColumnarColumn>& GetColumns() const;
+  const ColumnarColumn* GetColumn(const std::string& name) const;
+
+  bool HasMetadata(const std::string& key) const;
+  std::string GetMetadata(const std::string& key) const;
+
+  template<typename T>
+  const T* GetValues(const std::string& name) const{
+    //Returns NULL if the column is missing or does not hold values of type T
+    const ColumnarColumn* column(GetColumn(name));
+    if(column==NULL || column->type!=ColumnTraits<T>::type) return NULL;
+    return static_cast<const T*>(column->values);
+  }
+
+  template<typename T>
+  ColumnSpan<T> GetSpan(const std::string& name) const{
+    //Values of an unnested column. Bool columns may also be viewed as uint8_t.
+    const ColumnarColumn* column(GetColumn(name));
+    if(column==NULL || column->depth!=0) return ColumnSpan<T>();
+    if(column->type!=ColumnTraits<T>::type
+       && !(ColumnTraits<T>::type==kColumnUInt8 && column->type==kColumnBool)) return ColumnSpan<T>();
+    return ColumnSpan<T>(static_cast<const T*>(column->values), column->num_values);
+  }
+
+private:
+  ColumnarFile(const ColumnarFile&);
+  ColumnarFile& operator=(const ColumnarFile&);
+
+  void* map_;
+  uint64_t size_;
+  uint64_t num_entries_;
+  std::vector<ColumnarColumn> columns_;
+  std::map<std::string, std::size_t> column_index_;
+  std::map<std::string, std::string> metadata_;
+
+  bool Parse();
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef H_CUT_EXPRESSION
+#define H_CUT_EXPRESSION
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "columnar_file.hpp"
+
+//Cut or weight expression over reduced_tree branch names, e.g.
+//"num_jets>=6 && met>250 && passes_lepton_cut", compiled once into a flat list
+//of instructions and evaluated a batch of events at a time directly over the
+//columns of a ColumnarFile. Supports the subset of TTreeFormula syntax used for
+//reduced_tree selections: numbers, branch names, true/false, + - * / unary -,
+//comparisons, ! && ||, parentheses, and the functions abs, fabs, sqrt,
+//TMath::Abs and TMath::Sqrt. As in TTreeFormula, division by zero gives zero.
+class CutExpression{
+public:
+  static const std::size_t batch_size=1024;
+
+  explicit CutExpression(const std::string& expression);
+
+  bool IsValid() const;
+  const std::string& GetError() const;
+  const std::string& GetExpression() const;
+  const std::vector<std::string>& GetBranches() const;
+
+  bool Bind(const ColumnarFile& file);
+  const double* Evaluate(const uint64_t first_entry, const std::size_t num_entries);
+
+private:
+  enum OpCode{
+    kLoad, kConstant,
+    kNegate, kNot, kAbs, kSqrt,
+    kAdd, kSubtract, kMultiply, kDivide,
+    kLess, kLessEqual, kGreater, kGreaterEqual, kEqual, kNotEqual,
+    kAnd, kOr
+  };
+
+  struct Instruction{
+    OpCode op;
+    std::size_t out, a, b;
+    double constant;
+  };
+
+  struct Input{
+    ColumnType type;
+    const void* values;
+  };
+
+  std::string expression_, error_;
+  std::vector<std::string> branches_;
+  std::vector<Instruction> instructions_;
+  std::vector<Input> inputs_;
+  std::vector<double> registers_;
+  std::size_t num_registers_, result_;
+  bool bound_;
+
+  //Parser state, only used while compiling
+  std::string::size_type pos_;
+
+  bool Compile();
+  void SkipSpace();
+  bool Accept(const std::string& token);
+  bool ParseOr(std::size_t& reg);
+  bool ParseAnd(std::size_t& reg);
+  bool ParseEquality(std::size_t& reg);
+  bool ParseRelational(std::size_t& reg);
+  bool ParseAdditive(std::size_t& reg);
+  bool ParseMultiplicative(std::size_t& reg);
+  bool ParseUnary(std::size_t& reg);
+  bool ParsePrimary(std::size_t& reg);
+  bool Fail(const std::string& message);
+
+  std::size_t Emit(const OpCode op, const std::size_t a=0, const std::size_t b=0, const double constant=0.0);
+  std::size_t GetBranchIndex(const std::string& name);
+};
+
+#endif
@@ -12,32 +12,49 @@
 #include "TLorentzVector.h"
 #include "pu_constants.hpp"
 #include "lumi_reweighting_stand_alone.hpp"
+#include "trigger_index.hpp"
+#include "sample_traits.hpp"
+#include "mc_truth_index.hpp"
+#include "weights.hpp"
 #include "cfa.hpp"
+#include "file_stager.hpp"
 
 class EventHandler : public cfA{
 public:
   EventHandler(const std::string &, const bool, const double=1.0, const bool=false);
+  ~EventHandler();
 
   void SetScaleFactor(const double);
   void SetScaleFactor(const double, const double, const int);
+  bool EnableStaging(const std::string& scratch_dir, const uint64_t budget_bytes,
+                     const unsigned look_ahead=2);
 
 protected:
+  //Opens no input; every branch member is left for the caller to fill
+  explicit EventHandler(const std::string& sample_name);
+
   static const double CSVTCut, CSVMCut, CSVLCut;
   double scaleFactor;
 
   int GetcfAVersion() const;
+  const SampleTraits& GetSampleTraits() const;
+  void SetSampleName(const std::string&);
 
-  void GetEntry(const unsigned int);
+  int GetEntry(const unsigned int);
 
   std::vector<double> GetBeta(const std::string which="beta") const;
 
   double GetNumInteractions() const;
+  std::vector<float> GetPileupProfile(const unsigned num_bins, const unsigned num_threads);
+  GeneratedEventCounts CountGeneratedEvents(const unsigned num_threads);
+  std::vector<std::string> GetInputFiles() const;
   unsigned short GetNumVertices() const;
-  double GetPUWeight(reweight::LumiReWeighting &) const;
+  double GetPUWeight(const reweight::LumiReWeighting &) const;
 
   bool isGoodVertex(const unsigned int) const;
 
   bool PassesJSONCut() const;
+  std::vector<unsigned> GetCertifiedEntries();
   bool PassesPVCut() const;
   bool PassesMETCleaningCut() const;
   bool PassesLeptonCut() const;
@@ -49,6 +66,9 @@ protected:
   bool PassesBaselineSelection() const;
 
   bool PassesTrigger(const std::string&) const;
+  bool PassesTrigger(const std::size_t) const;
+  std::size_t AddTrigger(const std::vector<std::string>&) const;
+  uint64_t GetTriggerMask() const;
 
   bool PassesBadJetFilter() const;
 
@@ -83,6 +103,7 @@ protected:
 
   double GetElectronRelIso(const unsigned int) const;
 
+  const McTruthIndex& GetMcTruth() const;
   double GetTopPt() const;
   double GetTopPtWeight() const;
 
@@ -103,10 +124,31 @@ protected:
 
   std::vector<double> GetBLInvariantMasses(const unsigned num_bs, const double csv_cut);
   unsigned GetNumberOfGeneratedEMu(const bool check_W=true, const bool check_top=true) const;
+  McTruthIndex::TtbarDecay GetTtbarDecay() const;
 
 private:
+  std::string input_name_;
+  SampleTraits sample_traits_;
   mutable std::vector<double> beta_;
   mutable bool beta_cached_;
+  mutable McTruthIndex mc_truth_;
+  mutable bool mc_truth_cached_;
+  mutable TriggerIndex trigger_index_;
+  mutable bool trigger_decisions_cached_;
+  mutable int trigger_tree_;
+  mutable unsigned trigger_run_;
+  FileStager* stager_;
+  std::vector<std::string> staged_files_;
+  int staged_file_;
+
+  EventHandler(const EventHandler&);
+  EventHandler& operator=(const EventHandler&);
+
+  void StageFileOf(const unsigned);
+  void SetChainFileName(const int, const std::string&);
+  void UpdateTriggerDecisions() const;
+  Long64_t LoadTrees(const int);
+  bool IsCertified(const unsigned, const unsigned) const;
 };
 
 #endif
@@ -0,0 +1,51 @@
+#ifndef H_EVENT_HANDLER_BENCHMARK
+#define H_EVENT_HANDLER_BENCHMARK
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include "TRandom3.h"
+#include "event_handler.hpp"
+#include "lumi_reweighting_stand_alone.hpp"
+#include "weights.hpp"
+#include "timer.hpp"
+
+//Times EventHandler selectors and variables without any cfA ntuples. The handler
+//is constructed without any input, and every event is generated directly into
+//its branch members with multiplicities typical of 8 TeV ttbar. Results are
+//written as tab separated columns, one line per benchmark, so that runs of
+//different builds can be compared.
+class EventHandlerBenchmark : public EventHandler{
+public:
+  explicit EventHandlerBenchmark(const std::string& sample_name, const unsigned seed=4357);
+
+  void Run(const unsigned num_events, std::ostream& out);
+
+private:
+  enum Benchmark{
+    kTimerOverhead,
+    kGetBeta, kIsGoodJet, kIsElectron, kIsMuon, kIsTau,
+    kGetNumIsoTracks, kNewGetNumIsoTracks, kGetNumVertices,
+    kPassesJSONCut, kPassesMETCleaningCut, kPassesLeptonCut,
+    kGetHT, kGetMT2, kGetMT, kGetBLInvariantMasses,
+    kGetNumberOfGeneratedEMu, kGetTopPtWeight, kGetPUWeight, kGetWeight,
+    kNumBenchmarks
+  };
+
+  TRandom3 random_;
+  const reweight::LumiReWeighting lumi_weights_;
+  WeightCalculator weight_calculator_;
+  std::string data_sample_name_;
+
+  static const char* GetBenchmarkName(const Benchmark benchmark);
+
+  void GenerateEvent();
+  void GenerateJets();
+  void GenerateLeptons();
+  void GenerateTracks();
+  void GenerateVertices();
+  void GenerateGeneratorInfo();
+  double RunBenchmark(const Benchmark benchmark);
+};
+
+#endif
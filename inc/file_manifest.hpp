@@ -0,0 +1,51 @@
+#ifndef H_FILE_MANIFEST
+#define H_FILE_MANIFEST
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+//Files of a cfA input (a glob pattern or a list of files) with the entry counts
+//of their eventA and eventB trees. The counts are kept in a small text file in
+//cache_dir, so that later jobs can pass them to TChain::Add and the chains do
+//not open every file before the first event. A file's counts are only used
+//while its size and modification time are unchanged.
+class FileManifest{
+public:
+  FileManifest(const std::string& input, const bool is_list,
+               const std::string& cache_dir="cfa_cache");
+
+  std::size_t GetNumFiles() const;
+  const std::string& GetFileName(const std::size_t file) const;
+
+  bool IsKnown(const std::size_t file) const;
+  int64_t GetEntriesA(const std::size_t file) const;
+  int64_t GetEntriesB(const std::size_t file) const;
+  //First chain entry of the file, or -1 if an earlier file is not known
+  int64_t GetTreeOffset(const std::size_t file) const;
+  std::size_t GetNumKnown() const;
+
+  void SetEntries(const std::size_t file, const int64_t entries_a, const int64_t entries_b);
+  //Writes the manifest if any counts were added
+  bool Save();
+
+  const std::string& GetManifestName() const;
+
+private:
+  struct FileInfo{
+    std::string name;
+    int64_t size, mtime;
+    int64_t entries_a, entries_b;
+    bool exists, known;
+  };
+
+  std::string input_;
+  std::string manifest_name_;
+  std::vector<FileInfo> files_;
+  bool modified_;
+
+  static std::vector<std::string> ExpandInput(const std::string& input, const bool is_list);
+  void Load();
+};
+
+#endif
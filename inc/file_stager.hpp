@@ -0,0 +1,61 @@
+#ifndef H_FILE_STAGER
+#define H_FILE_STAGER
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <pthread.h>
+
+//Copies the input files of a job to local scratch in a background thread, a few
+//files ahead of the one being read. Acquire(i) is called when reading moves to
+//file i: it deletes the copies of earlier files, waits if file i is still being
+//copied, and returns the local copy or, if the file could not be staged in time
+//or within the disk budget, the original name so it is read directly.
+class FileStager{
+public:
+  FileStager(const std::vector<std::string>& files,
+             const std::string& scratch_dir,
+             const uint64_t budget_bytes,
+             const unsigned look_ahead=2);
+  ~FileStager();
+
+  bool IsRunning() const;
+
+  std::string Acquire(const std::size_t file);
+
+  std::size_t GetNumFiles() const;
+  std::size_t GetNumStaged() const;
+  std::size_t GetNumDirect() const;
+
+private:
+  FileStager(const FileStager&);
+  FileStager& operator=(const FileStager&);
+
+  enum FileState{
+    kPending, kCopying, kStaged, kDeleted, kDirect, kFailed
+  };
+
+  struct StagedFile{
+    std::string name, local_name;
+    uint64_t size;
+    FileState state;
+  };
+
+  std::vector<StagedFile> files_;
+  std::string scratch_dir_;
+  uint64_t budget_bytes_, used_bytes_;
+  std::size_t look_ahead_, current_;
+  std::size_t num_staged_, num_direct_;
+  bool stop_, running_;
+  mutable pthread_mutex_t mutex_;
+  pthread_cond_t changed_;
+  pthread_t thread_;
+
+  static void* Run(void* stager);
+  void Work();
+  bool Fits(const StagedFile& file) const;
+  bool Copy(const StagedFile& file) const;
+  void Delete(StagedFile& file);
+};
+
+#endif
@@ -1,18 +1,30 @@
 #ifndef H_CLASSMAKER
 #define H_CLASSMAKER
 
-#include <fstream>
+#include <ostream>
 #include <string>
+#include <vector>
+#include <set>
 #include "TFile.h"
 #include "TChain.h"
 #include "TLeafObject.h"
 
-void PrintLeaves(TChain *, std::ofstream &);
-void PrintBranches(TChain *, std::ofstream &);
-void PrintNullInit(TChain *, std::ofstream &);
-void PrintSetNull(TChain *, std::ofstream &);
-void PrintBranchInit(TChain *, std::ofstream &);
-void PrintSetBranchAddressA(TChain *, std::ofstream &);
-void PrintSetBranchAddressB(TChain *, std::ofstream &);
+struct Leaf{
+  std::string name, type;
+  bool isObject;
+};
+
+void AddWords(const std::string&, const bool, std::set<std::string>&);
+std::vector<Leaf> GetLeaves(TChain *, const std::set<std::string>&, const bool);
+void WriteIfChanged(const std::string&, const std::string&);
+void PrintLeaves(const std::vector<Leaf>&, std::ostream &);
+void PrintBranches(const std::vector<Leaf>&, std::ostream &);
+void PrintStorage(const std::vector<Leaf>&, std::ostream &);
+void PrintNullInit(const std::vector<Leaf>&, std::ostream &);
+void PrintSetNull(const std::vector<Leaf>&, std::ostream &);
+void PrintBranchInit(const std::vector<Leaf>&, std::ostream &);
+void PrintSetBranchStatus(const std::string&, const std::vector<Leaf>&, std::ostream &);
+void PrintSetBranchAddress(const std::string&, const std::vector<Leaf>&, std::ostream &);
+void PrintVisitBranches(const std::vector<Leaf>&, std::ostream &);
 
 #endif
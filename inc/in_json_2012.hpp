@@ -9,4 +9,22 @@ bool inJSON(std::vector<std::vector<int> > VRunLumi, int Run, int LS);
 void CheckVRunLumi(std::vector<std::vector<int> > VRunLumi);
 void CheckVRunLumi2(std::vector<std::vector<int> > VVRunLumi);
 
+//Same answers as inJSON, but the lumi section ranges are merged and sorted once so
+//that each lookup is a binary search instead of a scan over a copy of the JSON
+class LumiMask{
+public:
+  explicit LumiMask(const std::vector<std::vector<int> >& VVRunLumi);
+
+  bool Contains(const int run, const int lumiblock) const;
+  std::size_t GetNumRanges() const;
+
+private:
+  struct Range{
+    int run, first, last;
+    bool operator<(const Range& other) const;
+  };
+
+  std::vector<Range> ranges_;
+};
+
 #endif //INJSON2012_H
@@ -26,8 +26,10 @@
 #include "TRandom3.h"
 #include "TStopwatch.h"
 #include <string>
+#include <sstream>
 #include <vector>
 #include <cmath>
+#include "pileup_weights_3d.hpp"
 #include <algorithm>
 
 namespace reweight {
@@ -246,6 +248,8 @@ namespace reweight {
       Data_distr_ = static_cast<TH1*>(dataFile_->Get( DataHistName_.c_str() )->Clone() );
       //QQQ MC_distr_ = new TH1(  *(static_cast<TH1*>(generatedFile_->Get( GenHistName_.c_str() )->Clone() )) );
       MC_distr_ = static_cast<TH1*>(generatedFile_->Get( GenHistName_.c_str() )->Clone() );
+      Data_distr_->SetDirectory(0);
+      MC_distr_->SetDirectory(0);
           
       // normalize both histograms first                                                                            
 
@@ -261,6 +265,8 @@ namespace reweight {
 
       //QQQ TH1* den = new TH1(*(MC_distr_));
       TH1* den(static_cast<TH1*>(MC_distr_->Clone()));
+      weights_->SetDirectory(0);
+      den->SetDirectory(0);
 
       weights_->Divide( den );  // so now the average weight should be 1.0
 
@@ -295,11 +301,19 @@ namespace reweight {
 
       Int_t NBins = MC_distr.size();
 
-      MC_distr_ = new TH1F("MC_distr","MC dist",NBins,-0.5, float(NBins)-0.5);
-      Data_distr_ = new TH1F("Data_distr","Data dist",NBins,-0.5, float(NBins)-0.5);
+      // names are unique per instance and the histograms are kept out of gDirectory,
+      // so instances never replace each other's histograms
 
-      weights_ = new TH1F("luminumer","luminumer",NBins,-0.5, float(NBins)-0.5);
-      TH1* den = new TH1F("lumidenom","lumidenom",NBins,-0.5, float(NBins)-0.5);
+      const std::string suffix = GetUniqueSuffix();
+      MC_distr_ = new TH1F(("MC_distr"+suffix).c_str(),"MC dist",NBins,-0.5, float(NBins)-0.5);
+      Data_distr_ = new TH1F(("Data_distr"+suffix).c_str(),"Data dist",NBins,-0.5, float(NBins)-0.5);
+
+      weights_ = new TH1F(("luminumer"+suffix).c_str(),"luminumer",NBins,-0.5, float(NBins)-0.5);
+      TH1* den = new TH1F(("lumidenom"+suffix).c_str(),"lumidenom",NBins,-0.5, float(NBins)-0.5);
+      MC_distr_->SetDirectory(0);
+      Data_distr_->SetDirectory(0);
+      weights_->SetDirectory(0);
+      den->SetDirectory(0);
 
       for(int ibin = 1; ibin<=NBins; ++ibin ) {
         weights_->SetBinContent(ibin, Lumi_distr[ibin-1]);
@@ -345,166 +359,53 @@ namespace reweight {
 
     void weight3D_init( float ScaleFactor, std::string WeightOutputFile="") { 
 
-      //create histogram to write output weights, save pain of generating them again...
-
-      TH3D* WHist = new TH3D("WHist","3D weights",50,0.,50.,50,0.,50.,50,0.,50. );
-      TH3D* DHist = new TH3D("DHist","3D weights",50,0.,50.,50,0.,50.,50,0.,50. );
-      TH3D* MHist = new TH3D("MHist","3D weights",50,0.,50.,50,0.,50.,50,0.,50. );
-
-
-      using std::min;
+      //The matrices are computed in parallel by PileupWeights3D, or mapped from
+      //its cache if an earlier job used the same distributions and scale factor
 
       if( MC_distr_->GetEntries() == 0 ) {
         std::cout << " MC and Data distributions are not initialized! You must call the LumiReWeighting constructor. " << std::endl;
       }
 
-      // arrays for storing number of interactions
+      std::vector<double> mc_centers, mc_contents, data_centers, data_contents;
+      for (int jbin=1;jbin<=MC_distr_->GetNbinsX();jbin++) {
+        mc_centers.push_back(MC_distr_->GetBinCenter(jbin));
+        mc_contents.push_back(MC_distr_->GetBinContent(jbin));
+      }
+      for (int jbin=1;jbin<=Data_distr_->GetNbinsX();jbin++) {
+        data_centers.push_back(Data_distr_->GetBinCenter(jbin));
+        data_contents.push_back(Data_distr_->GetBinContent(jbin));
+      }
 
-      double MC_ints[50][50][50];
-      double Data_ints[50][50][50];
+      const PileupWeights3D matrices(mc_centers, mc_contents, data_centers, data_contents, ScaleFactor);
 
       for (int i=0; i<50; i++) {
         for(int j=0; j<50; j++) {
           for(int k=0; k<50; k++) {
-            MC_ints[i][j][k] = 0.;
-            Data_ints[i][j][k] = 0.;
-          }
-        }
-      }
-
-      double factorial[50];
-      double PowerSer[50];
-      double base = 1.;
-
-      factorial[0] = 1.;
-      PowerSer[0]=1.;
-
-      for (int i = 1; i<50; ++i) {
-        base = base*float(i);
-        factorial[i] = base;
-      }
-
-
-      double x;
-      double xweight;
-      double probi, probj, probk;
-      double Expval, mean;
-      int xi;
-
-      // Get entries for Data, MC, fill arrays:                                                                                                 
-      int NMCbin = MC_distr_->GetNbinsX();
-
-      for (int jbin=1;jbin<=NMCbin;jbin++) {
-        x =  MC_distr_->GetBinCenter(jbin);
-        xweight = MC_distr_->GetBinContent(jbin); //use as weight for matrix         
-
-        //for Summer 11, we have this int feature:                      
-        xi = int(x);
-
-        // Generate Poisson distribution for each value of the mean     
-        mean = double(xi);
-
-        if(mean<0.) {
-          std::cout << "LumiReweighting:BadInputValue" << " Your histogram generates MC luminosity values less than zero!"
-                    << " Please Check.  Terminating." << std::endl;
-        }
-
-
-        if(mean==0.){
-          Expval = 1.;
-        }
-        else {
-          Expval = exp(-1.*mean);
-        }
-
-        base = 1.;
-
-        for (int i = 1; i<50; ++i) {
-          base = base*mean;
-          PowerSer[i] = base; // PowerSer is mean^i                        
-        }
-
-        // compute poisson probability for each Nvtx in weight matrix      
-        for (int i=0; i<50; i++) {
-          probi = PowerSer[i]/factorial[i]*Expval;
-          for(int j=0; j<50; j++) {
-            probj = PowerSer[j]/factorial[j]*Expval;
-            for(int k=0; k<50; k++) {
-              probk = PowerSer[k]/factorial[k]*Expval;
-              // joint probability is product of event weights multiplied by weight of input distribution bin                                   
-              MC_ints[i][j][k] = MC_ints[i][j][k]+probi*probj*probk*xweight;
-            }
+            Weight3D_[i][j][k] = matrices.GetWeight(i,j,k);
           }
         }
-
       }
 
-      int NDatabin = Data_distr_->GetNbinsX();
-
-      for (int jbin=1;jbin<=NDatabin;jbin++) {
-        mean =  (Data_distr_->GetBinCenter(jbin))*ScaleFactor;
-        xweight = Data_distr_->GetBinContent(jbin);
-
-        // Generate poisson distribution for each value of the mean
-        if(mean<0.) {
-          std::cout << "LumiReweighting:BadInputValue" << " Your histogram generates MC luminosity values less than zero!"
-                    << " Please Check.  Terminating." << std::endl;
-        }
-
-        if(mean==0.){
-          Expval = 1.;
-        }
-        else {
-          Expval = exp(-1.*mean);
-        }
-
-        base = 1.;
+      if(! WeightOutputFile.empty() ) {
+        std::cout << " 3D Weight Matrix initialized! " << std::endl;
+        std::cout << " Writing weights to file " << WeightOutputFile << " for re-use...  " << std::endl;
 
-        for (int i = 1; i<50; ++i) {
-          base = base*mean;
-          PowerSer[i] = base;
-        }
+        //create histogram to write output weights, save pain of generating them again...
 
-        // compute poisson probability for each Nvtx in weight matrix                                                                           
+        TH3D* WHist = new TH3D("WHist","3D weights",50,0.,50.,50,0.,50.,50,0.,50. );
+        TH3D* DHist = new TH3D("DHist","3D weights",50,0.,50.,50,0.,50.,50,0.,50. );
+        TH3D* MHist = new TH3D("MHist","3D weights",50,0.,50.,50,0.,50.,50,0.,50. );
 
         for (int i=0; i<50; i++) {
-          probi = PowerSer[i]/factorial[i]*Expval;
           for(int j=0; j<50; j++) {
-            probj = PowerSer[j]/factorial[j]*Expval;
             for(int k=0; k<50; k++) {
-              probk = PowerSer[k]/factorial[k]*Expval;
-              // joint probability is product of event weights multiplied by weight of input distribution bin                                   
-              Data_ints[i][j][k] = Data_ints[i][j][k]+probi*probj*probk*xweight;
-            }
-          }
-        }
-
-      }
-
-
-      for (int i=0; i<50; i++) {
-        //if(i<5) std::cout << "i = " << i << std::endl;                       
-        for(int j=0; j<50; j++) {
-          for(int k=0; k<50; k++) {
-            if( (MC_ints[i][j][k])>0.) {
-              Weight3D_[i][j][k]  =  Data_ints[i][j][k]/MC_ints[i][j][k];
+              const int index = (i*50+j)*50+k;
+              WHist->SetBinContent( i+1,j+1,k+1,Weight3D_[i][j][k] );
+              DHist->SetBinContent( i+1,j+1,k+1,matrices.GetDataInts()[index] );
+              MHist->SetBinContent( i+1,j+1,k+1,matrices.GetMcInts()[index] );
             }
-            else {
-              Weight3D_[i][j][k]  = 0.;
-            }
-            WHist->SetBinContent( i+1,j+1,k+1,Weight3D_[i][j][k] );
-            DHist->SetBinContent( i+1,j+1,k+1,Data_ints[i][j][k] );
-            MHist->SetBinContent( i+1,j+1,k+1,MC_ints[i][j][k] );
-            //      if(i<5 && j<5 && k<5) std::cout << Weight3D_[i][j][k] << " " ;    
           }
-          //      if(i<5 && j<5) std::cout << std::endl;        
         }
-      }
-
-      if(! WeightOutputFile.empty() ) {
-        std::cout << " 3D Weight Matrix initialized! " << std::endl;
-        std::cout << " Writing weights to file " << WeightOutputFile << " for re-use...  " << std::endl;
-
 
         TFile * outfile = new TFile(WeightOutputFile.c_str(),"RECREATE");
         WHist->Write();
@@ -1307,23 +1208,26 @@ namespace reweight {
     }
 
 
-    double ITweight( int npv ){
-      int bin = weights_->GetXaxis()->FindBin( npv );
+    // The lookups below only read the weights, so one instance, once constructed,
+    // can be shared by any number of threads. weightOOT is the exception.
+
+    double ITweight( int npv ) const {
+      int bin = weights_->GetXaxis()->FindFixBin( npv );
       return weights_->GetBinContent( bin );
     }
 
-    double ITweight3BX( float ave_int ){
-      int bin = weights_->GetXaxis()->FindBin( ave_int );
+    double ITweight3BX( float ave_int ) const {
+      int bin = weights_->GetXaxis()->FindFixBin( ave_int );
       return weights_->GetBinContent( bin );
     }
 
-    double weight( float n_int ){
-      int bin = weights_->GetXaxis()->FindBin( n_int );
+    double weight( float n_int ) const {
+      int bin = weights_->GetXaxis()->FindFixBin( n_int );
       return weights_->GetBinContent( bin );
     }
 
 
-    double weight3D( int pv1, int pv2, int pv3 ) {
+    double weight3D( int pv1, int pv2, int pv3 ) const {
 
       using std::min;
 
@@ -1409,6 +1313,13 @@ namespace reweight {
 
   protected:
 
+    static std::string GetUniqueSuffix() {
+      static unsigned long next_id = 0;
+      std::ostringstream suffix;
+      suffix << '_' << __sync_fetch_and_add(&next_id, 1UL);
+      return suffix.str();
+    }
+
     std::string generatedFileName_;
     std::string dataFileName_;
     std::string GenHistName_;
@@ -5,6 +5,8 @@
 #include <vector>
 #include <iterator>
 #include <algorithm>
+#include <limits>
+#include <stdint.h>
 
 namespace Math{
   const double pi(4.0*atan(1.0));
@@ -30,67 +32,177 @@ namespace Math{
     }
   }
 
-  template<typename T>
-  typename T::value_type Sum(T begin, T end){
-    //Performs Kahan summation (more precise than naive summation for long lists of numbers)
-    typename T::value_type sum(0.0);
-    volatile typename T::value_type correction(0.0);
-    for(; begin!=end; ++begin){
-      const typename T::value_type corrected_val(*begin-correction);
-      const typename T::value_type temp_sum(sum+corrected_val);
-      correction=(temp_sum-sum)-corrected_val;
-      sum=temp_sum;
+  //Accumulates count, mean and variance of a stream of values in one pass.
+  //Values can be added one at a time (Welford's update) or as a range, and
+  //two RunningStats can be merged, so that partial results from separate
+  //threads or files combine into exactly the statistics of the whole sample.
+  class RunningStats{
+  public:
+    RunningStats():
+      count_(0),
+      mean_(0.0),
+      m2_(0.0){
+    }
+
+    void Add(const double value){
+      ++count_;
+      const double delta(value-mean_);
+      mean_+=delta/count_;
+      m2_+=delta*(value-mean_);
+    }
+
+    template<typename T>
+    void AddRange(T begin, T end){
+      //Exact two-pass statistics for blocks small enough to stay in cache,
+      //merged pairwise into the running totals
+      const unsigned block_size(4096);
+      double values[block_size];
+      while(begin!=end){
+        unsigned n(0);
+        double sum(0.0);
+        for(; n<block_size && begin!=end; ++n, ++begin){
+          values[n]=*begin;
+          sum+=values[n];
+        }
+        const double block_mean(sum/n);
+        double block_m2(0.0);
+        for(unsigned i(0); i<n; ++i){
+          const double residual(values[i]-block_mean);
+          block_m2+=residual*residual;
+        }
+        Merge(n, block_mean, block_m2);
+      }
+    }
+
+    void Add(const RunningStats& other){
+      Merge(other.count_, other.mean_, other.m2_);
+    }
+
+    uint64_t GetCount() const{return count_;}
+    double GetMean() const{return mean_;}
+    double GetVariance() const{return count_>0?m2_/count_:0.0;}
+    double GetSampleVariance() const{return count_>1?m2_/(count_-1):0.0;}
+
+  private:
+    uint64_t count_;
+    double mean_, m2_;
+
+    void Merge(const uint64_t count, const double mean, const double m2){
+      if(count==0) return;
+      const uint64_t total(count_+count);
+      const double delta(mean-mean_);
+      const double fraction(static_cast<double>(count)/total);
+      mean_+=delta*fraction;
+      m2_+=m2+delta*delta*count_*fraction;
+      count_=total;
+    }
+  };
+
+  namespace detail{
+    template<typename Value>
+    struct Identity{
+      Value operator()(const Value x) const{return x;}
+    };
+
+    template<typename Value>
+    struct SquaredResidual{
+      explicit SquaredResidual(const Value mean_in):mean(mean_in){}
+      Value operator()(const Value x) const{return (x-mean)*(x-mean);}
+      Value mean;
+    };
+
+    template<typename T, typename F>
+    typename std::iterator_traits<T>::value_type CompensatedSum(T begin, T end, const F& f){
+      //Kahan summation in four independent lanes. Each lane only depends on its
+      //own previous step, so the lanes can be computed in parallel (and
+      //vectorized), while the compensation keeps the accuracy of plain Kahan
+      //summation. Relies on the compiler not reassociating floating point
+      //arithmetic (no -ffast-math).
+      typedef typename std::iterator_traits<T>::value_type Value;
+      const int num_lanes(4);
+      Value sums[num_lanes]={0.0, 0.0, 0.0, 0.0};
+      Value corrections[num_lanes]={0.0, 0.0, 0.0, 0.0};
+      typename std::iterator_traits<T>::difference_type remaining(std::distance(begin, end));
+      for(; remaining>=num_lanes; remaining-=num_lanes){
+        for(int lane(0); lane<num_lanes; ++lane, ++begin){
+          const Value corrected_val(f(*begin)-corrections[lane]);
+          const Value temp_sum(sums[lane]+corrected_val);
+          corrections[lane]=(temp_sum-sums[lane])-corrected_val;
+          sums[lane]=temp_sum;
+        }
+      }
+      for(; begin!=end; ++begin){
+        const Value corrected_val(f(*begin)-corrections[0]);
+        const Value temp_sum(sums[0]+corrected_val);
+        corrections[0]=(temp_sum-sums[0])-corrected_val;
+        sums[0]=temp_sum;
+      }
+      Value sum(0.0), correction(0.0);
+      for(int lane(0); lane<num_lanes; ++lane){
+        const Value corrected_val(sums[lane]-corrections[lane]-correction);
+        const Value temp_sum(sum+corrected_val);
+        correction=(temp_sum-sum)-corrected_val;
+        sum=temp_sum;
+      }
+      return sum;
     }
-    return sum;
   }
 
   template<typename T>
-  typename T::value_type Mean(T begin, T end){
-    return Sum(begin, end)/static_cast<typename T::value_type>(std::distance(begin,end));
+  typename std::iterator_traits<T>::value_type Sum(T begin, T end){
+    //Compensated (Kahan) summation: more precise than naive summation for long lists of numbers
+    return detail::CompensatedSum(begin, end, detail::Identity<typename std::iterator_traits<T>::value_type>());
   }
 
   template<typename T>
-  typename T::value_type Variance(T begin, T end){
-    const typename T::value_type mean(Mean(begin, end));
-    std::vector<typename T::value_type> residuals_squared(0);
-    for(T it(begin); it!=end; ++it){
-      const typename T::value_type residual(*it-mean);
-      residuals_squared.push_back(residual*residual);
-    }
-    return Sum(residuals_squared.begin(), residuals_squared.end())/static_cast<typename T::value_type>(std::distance(begin,end));
+  typename std::iterator_traits<T>::value_type Mean(T begin, T end){
+    return Sum(begin, end)/static_cast<typename std::iterator_traits<T>::value_type>(std::distance(begin,end));
+  }
+
+  template<typename T>
+  typename std::iterator_traits<T>::value_type Variance(T begin, T end){
+    //Population variance from two compensated passes, without temporary storage
+    typedef typename std::iterator_traits<T>::value_type Value;
+    const Value mean(Mean(begin, end));
+    return detail::CompensatedSum(begin, end, detail::SquaredResidual<Value>(mean))
+      /static_cast<Value>(std::distance(begin,end));
   }
 
   template<typename T>
-  typename T::value_type Median(T begin, T end){
+  typename std::iterator_traits<T>::value_type Median(T begin, T end){
     //N.B.: As implemented, this function may reorder elements in the input range.
-    std::sort(begin, end);
-    const typename T::difference_type separation(std::distance(begin, end));
-    end=begin;
-    std::advance(end, floor(0.5*separation));
+    typedef typename std::iterator_traits<T>::value_type Value;
+    const typename std::iterator_traits<T>::difference_type separation(std::distance(begin, end));
+    if(separation==0) return std::numeric_limits<Value>::quiet_NaN();
+    T middle(begin);
+    std::advance(middle, separation/2);
+    std::nth_element(begin, middle, end);
     if(separation & 0x1ul){
-      return *end;
+      return *middle;
     }else{
-      std::advance(begin, floor(0.5*separation)-1);
-      return 0.5*((*begin)+(*end));
+      //After nth_element, the lower middle value is the largest one before middle
+      return 0.5*((*std::max_element(begin, middle))+(*middle));
     }
   }
 
   template<typename T>
-  typename T::value_type HalfSampleMode(T begin, T end){
-    //N.B.: As implemented, this function may reorder elements in the input range.
+  typename std::iterator_traits<T>::value_type HalfSampleMode(T begin, T end){
+    //N.B.: As implemented, this function sorts the input range. Each step keeps
+    //the densest half of the previous range, so after the sort the search is O(n).
+    typedef typename std::iterator_traits<T>::value_type Value;
     std::sort(begin, end);
-    const typename T::difference_type separation(std::distance(begin, end));
-    if(separation<=1){
-      return 0.5*((*begin)+(*end));
-    }else{
+    typename std::iterator_traits<T>::difference_type separation(std::distance(begin, end));
+    if(separation==0) return std::numeric_limits<Value>::quiet_NaN();
+    if(separation==1) return *begin;
+    while(separation>1){
       T inner_begin(begin), inner_end(begin);
-      std::advance(inner_end, ceil(0.5*separation));
-      typename T::value_type min_delta((*inner_end)-(*inner_begin));
+      std::advance(inner_end, (separation+1)/2);
+      Value min_delta((*inner_end)-(*inner_begin));
       T min_begin(inner_begin), min_end(inner_end);
       ++inner_begin;
       ++inner_end;
       while(inner_end!=end){
-        const typename T::value_type this_delta((*inner_end)-(*inner_begin));
+        const Value this_delta((*inner_end)-(*inner_begin));
         if(this_delta<min_delta){
           min_delta=this_delta;
           min_begin=inner_begin;
@@ -99,8 +211,11 @@ namespace Math{
         ++inner_begin;
         ++inner_end;
       }
-      return HalfSampleMode(min_begin, min_end);
+      begin=min_begin;
+      end=min_end;
+      separation=std::distance(begin, end);
     }
+    return 0.5*((*begin)+(*end));
   }
 }
 
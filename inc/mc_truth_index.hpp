@@ -0,0 +1,51 @@
+#ifndef H_MC_TRUTH_INDEX
+#define H_MC_TRUTH_INDEX
+
+#include <vector>
+
+//Integer view of the generator record (mc_doc_*) for one event. Build converts
+//the float PDG ids once and sorts the particles of interest into per-species
+//lists, so generator level counts and lookups only visit the matching
+//particles. Mother and grandmother are stored as PDG ids, as in the cfA record.
+class McTruthIndex{
+public:
+  enum Species{
+    kElectrons, kMuons, kTaus, kNeutrinos,
+    kTops, kWs, kBQuarks,
+    kNumSpecies
+  };
+
+  enum TtbarDecay{
+    kNotTtbar=0,
+    kFullyHadronic=1,
+    kSemileptonic=2,
+    kDileptonic=3
+  };
+
+  McTruthIndex();
+
+  void Build(const std::vector<float>& ids,
+             const std::vector<float>& mother_ids,
+             const std::vector<float>& grandmother_ids);
+
+  std::size_t GetNumParticles() const;
+  int GetId(const std::size_t particle) const;
+  int GetMotherId(const std::size_t particle) const;
+  int GetGrandmotherId(const std::size_t particle) const;
+
+  //Indices into mc_doc_* in generator record order, both charges
+  const std::vector<unsigned>& GetParticles(const Species species) const;
+
+  unsigned GetNumEMu(const bool check_W=true, const bool check_top=true) const;
+  unsigned GetNumLeptonsFromTop() const;
+  TtbarDecay GetTtbarDecay() const;
+
+private:
+  std::vector<int> ids_, mother_ids_, grandmother_ids_;
+  std::vector<std::vector<unsigned> > species_;
+
+  static int ToPdgId(const float id);
+  static bool IsFromTop(const int mother_id, const int grandmother_id);
+};
+
+#endif
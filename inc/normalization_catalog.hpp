@@ -0,0 +1,29 @@
+#ifndef H_NORMALIZATION_CATALOG
+#define H_NORMALIZATION_CATALOG
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "weights.hpp"
+
+//Text file of generated event counts, one entry per dataset. An entry is only
+//used if the key of the input files still matches, so adding, removing or
+//rewriting a file of the dataset makes the next job count it again.
+class NormalizationCatalog{
+public:
+  explicit NormalizationCatalog(const std::string& file_name="cfa_cache/normalization_catalog.txt");
+
+  const std::string& GetFileName() const;
+
+  bool Find(const std::string& dataset, const uint64_t key, GeneratedEventCounts& counts) const;
+  bool Store(const std::string& dataset, const uint64_t key, const GeneratedEventCounts& counts) const;
+
+  //64 bit FNV-1a over the file names and, for files that exist, their size and
+  //modification time
+  static uint64_t GetKey(const std::vector<std::string>& files);
+
+private:
+  std::string file_name_;
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef H_PILEUP_WEIGHTS
+#define H_PILEUP_WEIGHTS
+
+#include <vector>
+#include <string>
+
+//Pileup weights for any number of data scenarios, kept in one flat table over
+//the true number of interactions. The binning and the float rounding of each
+//step follow the TH1F based LumiReWeighting(std::vector<float>, std::vector<float>),
+//so GetWeight gives the same value as LumiReWeighting::weight, but without
+//ROOT objects or global histogram names. GetWeights returns the weights of all
+//scenarios for one event with a single bin lookup.
+class PileupWeights{
+public:
+  explicit PileupWeights(const std::vector<float>& mc_profile);
+
+  bool AddScenario(const std::string& name, const std::vector<float>& data_profile);
+
+  std::size_t GetNumBins() const;
+  std::size_t GetNumScenarios() const;
+  const std::string& GetName(const std::size_t scenario) const;
+
+  std::size_t FindBin(const double true_interactions) const{
+    //Bin 0 and num_bins+1 are the under- and overflow and have weight 0
+    if(!(true_interactions>=-0.5)) return 0;
+    if(true_interactions>=num_bins_-0.5) return num_bins_+1;
+    return 1+static_cast<std::size_t>(num_bins_*(true_interactions+0.5)/num_bins_);
+  }
+
+  const float* GetWeights(const double true_interactions) const{
+    return &table_[FindBin(true_interactions)*names_.size()];
+  }
+
+  double GetWeight(const std::size_t scenario, const double true_interactions) const;
+
+  static std::vector<float> MakeProfile(const float* const begin, const std::size_t num_bins);
+
+private:
+  std::size_t num_bins_;
+  std::vector<float> mc_profile_;
+  std::vector<std::string> names_;
+  std::vector<float> table_;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef H_PILEUP_WEIGHTS_3D
+#define H_PILEUP_WEIGHTS_3D
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+//The 50x50x50 matrices of LumiReWeighting::weight3D_init: the Poisson
+//probabilities of the numbers of interactions in the previous, current and next
+//bunch crossing summed over the MC and data distributions, and their ratio. The
+//outer index is split among threads, each matrix element is summed over the bins
+//in the same order as before, so the result does not depend on the number of
+//threads. The matrices are cached in cache_dir under a hash of the bin centers,
+//the bin contents and the scale factor and mapped from there by later jobs.
+class PileupWeights3D{
+public:
+  static const unsigned num_values=50;
+
+  PileupWeights3D(const std::vector<double>& mc_centers,
+                  const std::vector<double>& mc_contents,
+                  const std::vector<double>& data_centers,
+                  const std::vector<double>& data_contents,
+                  const float scale_factor,
+                  const unsigned num_threads=0,
+                  const std::string& cache_dir=GetDefaultCacheDir());
+  ~PileupWeights3D();
+
+  double GetWeight(const unsigned i, const unsigned j, const unsigned k) const{
+    return weights_[(i*num_values+j)*num_values+k];
+  }
+
+  //num_values^3 values each, with the last index running fastest
+  const double* GetWeights() const;
+  const double* GetMcInts() const;
+  const double* GetDataInts() const;
+
+  uint64_t GetHash() const;
+  const std::string& GetCacheFileName() const;
+  bool IsFromCache() const;
+
+  static std::string GetDefaultCacheDir();
+
+private:
+  PileupWeights3D(const PileupWeights3D&);
+  PileupWeights3D& operator=(const PileupWeights3D&);
+
+  uint64_t hash_;
+  std::string cache_file_name_;
+  void* map_;
+  std::size_t map_size_;
+  std::vector<double> computed_;
+  const double *weights_, *mc_ints_, *data_ints_;
+
+  static uint64_t Hash(const std::vector<double>& mc_centers,
+                       const std::vector<double>& mc_contents,
+                       const std::vector<double>& data_centers,
+                       const std::vector<double>& data_contents,
+                       const float scale_factor);
+  bool MapCache();
+  void Compute(const std::vector<double>& mc_centers,
+               const std::vector<double>& mc_contents,
+               const std::vector<double>& data_centers,
+               const std::vector<double>& data_contents,
+               const float scale_factor,
+               unsigned num_threads);
+  void WriteCache() const;
+  void SetPointers(const double* const begin);
+};
+
+#endif
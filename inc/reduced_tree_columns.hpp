@@ -0,0 +1,43 @@
+#ifndef H_REDUCED_TREE_COLUMNS
+#define H_REDUCED_TREE_COLUMNS
+
+#include <string>
+#include <stdint.h>
+#include "columnar_file.hpp"
+
+//Uncompressed, memory-mapped copy of a reduced_tree file. Every reduced_tree
+//branch becomes one fixed width column and the meta_info entries are kept as
+//metadata, so scans over a column run directly over the mapped file.
+
+bool ExportReducedTree(const std::string& root_file_name,
+                       const std::string& columns_file_name);
+
+std::string GetReducedTreeColumnsName(const std::string& root_file_name);
+bool ReducedTreeColumnsAreOutOfDate(const std::string& root_file_name);
+
+class ReducedTreeColumns{
+public:
+  explicit ReducedTreeColumns(const std::string& file_name);
+
+  bool IsOpen() const;
+  uint64_t GetNumEntries() const;
+
+  std::string GetOriginalFileName() const;
+  int GetReducedTreeVersion() const;
+  std::string GetMetaInfo(const std::string& name) const;
+
+  ColumnSpan<float> GetFloat(const std::string& branch) const;
+  ColumnSpan<uint8_t> GetUInt8(const std::string& branch) const;
+
+  template<typename T>
+  ColumnSpan<T> Get(const std::string& branch) const{
+    return file_.GetSpan<T>(branch);
+  }
+
+  const ColumnarFile& GetFile() const;
+
+private:
+  ColumnarFile file_;
+};
+
+#endif
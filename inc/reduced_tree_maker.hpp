@@ -2,6 +2,7 @@
 #define H_REDUCED_TREE_MAKER
 
 #include <string>
+#include <vector>
 #include <stdint.h>
 #include "event_handler.hpp"
 
@@ -11,10 +12,15 @@ public:
                    const bool is_list,
                    const double weight_in=1.0);
 
-  void MakeReducedTree(const std::string& out_file_name);
+  void MakeReducedTree(const std::string& out_file_name, const bool certified_only=false,
+                       const bool sample_pileup_profile=false,
+                       const bool measured_normalization=false);
 
 private:
   static const uint16_t reduced_tree_version;
+
+  std::vector<float> GetSamplePileupProfile(const std::string& out_file_name);
+  GeneratedEventCounts GetSampleEventCounts();
 };
 
 #endif
@@ -0,0 +1,65 @@
+#ifndef H_REDUCED_TREE_WRITER
+#define H_REDUCED_TREE_WRITER
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <stdint.h>
+#include <pthread.h>
+#include "TTree.h"
+
+//Fills a TTree from a separate thread, so that basket compression and writing
+//do not hold up the event loop. Branch(name, value) makes a branch of the tree
+//for a variable of the event loop; Fill() copies all such variables into a
+//record of the block being filled, and full blocks are handed to the writer
+//thread, which copies each record to the branch buffers and calls TTree::Fill in
+//order. The tree therefore gets the same entries as if it were filled directly.
+//Only fixed-size values can be branched. The tree must not be used until Finish().
+class ReducedTreeWriter{
+public:
+  explicit ReducedTreeWriter(TTree& tree,
+                             const std::size_t records_per_block=4096,
+                             const std::size_t num_blocks=2);
+  ~ReducedTreeWriter();
+
+  template<typename T>
+  TBranch* Branch(const std::string& name, T& value){
+    return tree_.Branch(name.c_str(), static_cast<T*>(AddColumn(&value, sizeof(T))));
+  }
+
+  //Starts the writer thread; without it, Fill() fills the tree directly
+  bool Start();
+  void Fill();
+  //Writes the records still queued and stops the writer thread
+  void Finish();
+
+private:
+  ReducedTreeWriter(const ReducedTreeWriter&);
+  ReducedTreeWriter& operator=(const ReducedTreeWriter&);
+
+  struct Column{
+    const void* source;
+    void* slot;
+    std::size_t size, offset;
+  };
+
+  TTree& tree_;
+  std::vector<Column> columns_;
+  std::deque<std::vector<uint64_t> > slots_;
+  std::size_t record_size_, records_per_block_;
+  std::vector<std::vector<char> > blocks_;
+  std::vector<std::size_t> block_sizes_;
+  std::size_t first_full_, num_full_, fill_block_, num_filled_;
+  bool stop_, running_;
+  pthread_mutex_t mutex_;
+  pthread_cond_t changed_;
+  pthread_t thread_;
+
+  void* AddColumn(const void* source, const std::size_t size);
+  void CommitBlock();
+  void WriteRecord(const char* record);
+  static void* Run(void* writer);
+  void Work();
+};
+
+#endif
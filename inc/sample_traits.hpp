@@ -0,0 +1,19 @@
+#ifndef H_SAMPLE_TRAITS
+#define H_SAMPLE_TRAITS
+
+#include <string>
+
+//Everything the event selection needs to know about a sample that follows from
+//its name alone. EventHandler resolves it once when the input is opened, so the
+//per-event selections compare flags instead of searching the sample name.
+struct SampleTraits{
+  explicit SampleTraits(const std::string& sample_name="");
+
+  std::string name;
+  int cfa_version;//0 if the name has no _v<number>
+  bool is_data, is_sms, is_ttbar;
+  bool uses_prompt_reco_json, uses_24aug_json, uses_13jul_json;
+  bool skips_hbhe_filter, skips_ecal_laser_filter, skips_beta_cut;
+};
+
+#endif
@@ -2,6 +2,9 @@
 #define H_TIMER
 
 #include <ctime>
+#include <string>
+#include <vector>
+#include <stdint.h>
 
 class Timer{
 public:
@@ -11,9 +14,47 @@ public:
   void Iterate();
   void PrintRemainingTime() const;
   double GetRemainingTime() const;
+  double GetElapsedTime() const;
+
+  //Named sections accumulate time and call counts, e.g. per stage of an event
+  //loop. Use ScopedTimer to time a block of code.
+  unsigned AddSection(const std::string&);
+  void AddSectionTime(const unsigned section, const uint64_t nanoseconds){
+    sectionTimes[section]+=nanoseconds;
+    ++sectionCalls[section];
+  }
+  unsigned GetNumSections() const;
+  const std::string& GetSectionName(const unsigned) const;
+  double GetSectionTime(const unsigned) const;
+  unsigned long GetSectionCalls(const unsigned) const;
+  void PrintSections() const;
+
+  static uint64_t GetNanoseconds();
 private:
-  time_t startTime;
+  uint64_t startTime;
   unsigned long numIts, curIts;
+  std::vector<std::string> sectionNames;
+  std::vector<uint64_t> sectionTimes;
+  std::vector<unsigned long> sectionCalls;
+};
+
+class ScopedTimer{
+public:
+  ScopedTimer(Timer& timerIn, const unsigned sectionIn):
+    timer(timerIn),
+    section(sectionIn),
+    startTime(Timer::GetNanoseconds()){
+  }
+  ~ScopedTimer(){
+    timer.AddSectionTime(section, Timer::GetNanoseconds()-startTime);
+  }
+private:
+  ScopedTimer(const ScopedTimer&);
+  ScopedTimer& operator=(const ScopedTimer&);
+
+  Timer& timer;
+  const unsigned section;
+  const uint64_t startTime;
 };
 
 #endif
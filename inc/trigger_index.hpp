@@ -0,0 +1,51 @@
+#ifndef H_TRIGGER_INDEX
+#define H_TRIGGER_INDEX
+
+#include <vector>
+#include <string>
+#include <map>
+#include <stdint.h>
+
+//Resolves triggers, given as substrings of trigger_name entries like
+//EventHandler::PassesTrigger takes, to positions in the trigger menu. The
+//patterns are only matched again when the menu changes, which SetMenu detects
+//from a hash of the names. SetDecisions turns one event's decisions and
+//prescales into a bitset over the menu, so each trigger is then a few word-wise
+//ANDs. A trigger made from several patterns passes if any of them fired.
+class TriggerIndex{
+public:
+  static const std::size_t max_mask_triggers=64;
+
+  TriggerIndex();
+
+  std::size_t AddTrigger(const std::string& pattern);
+  std::size_t AddTrigger(const std::vector<std::string>& patterns);
+  std::size_t GetNumTriggers() const;
+  bool FindTrigger(const std::string& pattern, std::size_t& trigger) const;
+
+  bool SetMenu(const std::vector<std::string>& names);
+  uint64_t GetMenuHash() const;
+  std::size_t GetMenuSize() const;
+  const std::vector<std::size_t>& GetMenuPositions(const std::size_t trigger) const;
+
+  void SetDecisions(const std::vector<float>& decisions,
+                    const std::vector<float>& prescales);
+
+  bool Passes(const std::size_t trigger) const;
+  uint64_t GetPassedMask() const;
+
+  static uint64_t HashMenu(const std::vector<std::string>& names);
+
+private:
+  std::vector<std::vector<std::string> > patterns_;
+  std::map<std::string, std::size_t> single_pattern_triggers_;
+  std::vector<std::vector<uint64_t> > masks_;
+  std::vector<std::vector<std::size_t> > positions_;
+  std::vector<std::string> menu_;
+  uint64_t menu_hash_;
+  std::vector<uint64_t> fired_;
+
+  void Resolve(const std::size_t trigger);
+};
+
+#endif
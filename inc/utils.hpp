@@ -18,6 +18,11 @@ void get_count_and_uncertainty(TTree& tree,
                                double& count,
                                double& uncertainty);
 
+void get_counts_and_uncertainties(TTree& tree,
+                                  const std::vector<std::string>& cuts,
+                                  std::vector<double>& counts,
+                                  std::vector<double>& uncertainties);
+
 void add_point(TGraph& graph, const double x, const double y);
 double get_maximum(const TH1& h);
 double get_maximum(const TGraph& h);
@@ -0,0 +1,69 @@
+#ifndef H_WEIGHTED_HISTOGRAM
+#define H_WEIGHTED_HISTOGRAM
+
+#include <vector>
+#include <string>
+#include "TH1D.h"
+
+//Fixed binning histogram of weighted entries that many threads can fill without
+//locks. Every thread fills its own slot, a separate sumw/sumw2 array padded so
+//that no two slots share a cache line, and Merge adds the slots into the totals
+//in slot order. As long as each slot always gets the same entries, e.g. slot i
+//fills the i-th block of a file or the i-th file of a list, the totals do not
+//depend on thread scheduling. Bins are numbered as in TH1, with 0 the underflow
+//and num_bins+1 the overflow, and GetTH1D gives a TH1D for the utils.hpp helpers.
+class WeightedHistogram{
+public:
+  WeightedHistogram(const unsigned num_bins,
+                    const double low,
+                    const double high,
+                    const std::size_t num_slots=1);
+
+  unsigned GetNumBins() const;
+  double GetLow() const;
+  double GetHigh() const;
+  std::size_t GetNumSlots() const;
+
+  unsigned FindBin(const double x) const{
+    if(x<low_) return 0;
+    if(x>=high_) return num_bins_+1;
+    const unsigned bin(1+static_cast<unsigned>((x-low_)*scale_));
+    return bin>num_bins_?num_bins_:bin;
+  }
+
+  //Only one thread may fill a given slot at a time. NaN values and zero weights
+  //are skipped, so cut*weight can be passed directly as the weight.
+  void Fill(const std::size_t slot, const double x, const double w){
+    if(w==0.0 || x!=x) return;
+    double* const sums(&slots_[slot*stride_]);
+    const unsigned bin(FindBin(x));
+    sums[2*bin]+=w;
+    sums[2*bin+1]+=w*w;
+    sums[entries_offset_]+=1.0;
+  }
+  void Fill(const std::size_t slot, const double* const x, const double* const w,
+            const std::size_t num_values);
+
+  //Neither Merge nor the functions below may run while other threads are filling
+  void Merge();
+  bool Add(const WeightedHistogram& other);
+  void Reset();
+
+  double GetSumW(const unsigned bin) const;
+  double GetSumW2(const unsigned bin) const;
+  double GetError(const unsigned bin) const;
+  double GetEntries() const;
+  double GetIntegral() const;
+
+  TH1D GetTH1D(const std::string& name, const std::string& title="") const;
+  bool CopyTo(TH1D& histo) const;
+
+private:
+  unsigned num_bins_;
+  double low_, high_, scale_;
+  std::size_t num_slots_, stride_, entries_offset_;
+  std::vector<double> slots_, sumw_, sumw2_;
+  double entries_;
+};
+
+#endif
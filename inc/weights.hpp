@@ -3,6 +3,15 @@
 
 #include <string>
 #include <map>
+#include <utility>
+
+//Number of generated events in a sample, and for SMS scans per (mass1, mass2) point
+struct GeneratedEventCounts{
+  GeneratedEventCounts();
+
+  int total;
+  std::map<std::pair<int, int>, int> mass_points;
+};
 
 class WeightCalculator{
 public:
@@ -16,16 +25,20 @@ public:
 
   int GetTotalEvents(const std::string&) const;
   int GetTotalEvents(const std::string&, const int, const int) const;
+  //Counts measured on the sample itself; used instead of the built-in table for
+  //exactly this process name
+  void SetTotalEvents(const std::string&, const GeneratedEventCounts&);
 
   double GetWeight(const std::string&, const int m1=-1, const int m2=-1) const;
 
 private:
-  static std::map<std::string, double> crossSectionTable;
-  static std::map<std::string, int> totalEventsTable;
+  static const std::map<std::string, double> crossSectionTable;
+  static const std::map<std::string, int> totalEventsTable;
   double lumi;
+  std::map<std::string, GeneratedEventCounts> measuredEvents;
 
-  void SetCrossSections();
-  void SetTotalEvents();
+  static std::map<std::string, double> MakeCrossSectionTable();
+  static std::map<std::string, int> MakeTotalEventsTable();
 
   static int GetT1tttt14TeVTotalEvents(const int m1, const int m2);
   static double GetT1tttt14TeVCrossSection(const int m1, const int m2);
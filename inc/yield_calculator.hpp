@@ -0,0 +1,50 @@
+#ifndef H_YIELD_CALCULATOR
+#define H_YIELD_CALCULATOR
+
+#include <vector>
+#include <string>
+#include "TTree.h"
+#include "columnar_file.hpp"
+
+//Accumulates weighted yields for any number of selections in a single pass over
+//a reduced_tree. Each distinct cut or weight expression is compiled once, and
+//each region gets the same count and uncertainty get_count_and_uncertainty
+//would give for the cut string cut*weight. Filling from a ColumnarFile (see
+//reduced_tree_columns.hpp) uses CutExpression instead of TTreeFormula.
+class YieldCalculator{
+public:
+  explicit YieldCalculator(const std::string& default_weight="1");
+
+  std::size_t AddRegion(const std::string& name,
+                        const std::string& cut,
+                        const std::string& weight="");
+
+  std::size_t GetNumRegions() const;
+  const std::string& GetName(const std::size_t region) const;
+
+  void Fill(TTree& tree);
+  bool Fill(const ColumnarFile& file);
+  void Reset();
+
+  void GetCountAndUncertainty(const std::size_t region,
+                              double& count,
+                              double& uncertainty) const;
+  bool GetCountAndUncertainty(const std::string& name,
+                              double& count,
+                              double& uncertainty) const;
+
+private:
+  struct Region{
+    std::string name;
+    std::size_t cut, weight;
+    double sumw, sumw2;
+  };
+
+  std::string default_weight_;
+  std::vector<Region> regions_;
+  std::vector<std::string> expressions_;
+
+  std::size_t AddExpression(const std::string& expression);
+};
+
+#endif
@@ -0,0 +1,149 @@
+/*
+  Compares the time needed to compute a weighted yield with TTreeFormula (get_count_and_uncertainty and YieldCalculator on the reduced_tree) and with compiled CutExpressions on the columnar copy.
+  Input: reduced_tree format .root file given with -i. If not given, a synthetic reduced_tree is generated first.
+  Output: counts, uncertainties and timings printed to stdout
+  Options:
+  -i: Set input reduced_tree file name
+  -o: File name for the synthetic reduced_tree (default benchmark_reduced_tree.root)
+  -n: Number of events in the synthetic reduced_tree (default 10000000)
+  -c: Cut (default "num_jets>=6 && met>250 && passes_lepton_cut")
+  -w: Weight (default full_weight)
+*/
+
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <unistd.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include "TFile.h"
+#include "TTree.h"
+#include "reduced_tree_columns.hpp"
+#include "yield_calculator.hpp"
+#include "utils.hpp"
+
+namespace{
+  double GetWallTime(){
+    timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec+1.e-6*now.tv_usec;
+  }
+
+  double Uniform(){
+    return rand()/(RAND_MAX+1.0);
+  }
+
+  void MakeSyntheticReducedTree(const std::string& file_name, const unsigned num_events){
+    TFile file(file_name.c_str(), "recreate");
+    file.cd();
+    TTree reduced_tree("reduced_tree", "reduced_tree");
+    bool passes_lepton_cut(false);
+    uint8_t num_jets(0), num_csvm_jets(0);
+    float met(0.0), ht_jets(0.0), full_weight(0.0);
+    reduced_tree.Branch("passes_lepton_cut", &passes_lepton_cut);
+    reduced_tree.Branch("num_jets", &num_jets);
+    reduced_tree.Branch("num_csvm_jets", &num_csvm_jets);
+    reduced_tree.Branch("met", &met);
+    reduced_tree.Branch("ht_jets", &ht_jets);
+    reduced_tree.Branch("full_weight", &full_weight);
+
+    srand(12345);
+    for(unsigned event(0); event<num_events; ++event){
+      passes_lepton_cut=Uniform()<0.3;
+      num_jets=static_cast<uint8_t>(12.0*Uniform());
+      num_csvm_jets=static_cast<uint8_t>((num_jets+1)*Uniform());
+      met=-100.0*log(1.0-Uniform());
+      ht_jets=50.0*num_jets*(0.5+Uniform());
+      full_weight=0.01+0.1*Uniform();
+      reduced_tree.Fill();
+    }
+    reduced_tree.Write();
+    file.Close();
+  }
+}
+
+int main(int argc, char *argv[]){
+  std::string in_file_name(""), synthetic_file_name("benchmark_reduced_tree.root");
+  std::string cut("num_jets>=6 && met>250 && passes_lepton_cut"), weight("full_weight");
+  unsigned num_events(10000000);
+
+  int c(0);
+  while((c=getopt(argc, argv, "i:o:n:c:w:"))!=-1){
+    switch(c){
+    case 'i':
+      in_file_name=optarg;
+      break;
+    case 'o':
+      synthetic_file_name=optarg;
+      break;
+    case 'n':
+      num_events=atoi(optarg);
+      break;
+    case 'c':
+      cut=optarg;
+      break;
+    case 'w':
+      weight=optarg;
+      break;
+    default:
+      break;
+    }
+  }
+
+  if(in_file_name==""){
+    std::cout << "Generating " << num_events << " events in " << synthetic_file_name << std::endl;
+    MakeSyntheticReducedTree(synthetic_file_name, num_events);
+    in_file_name=synthetic_file_name;
+  }
+  const std::string columns_file_name(GetReducedTreeColumnsName(in_file_name));
+  if(!ExportReducedTree(in_file_name, columns_file_name)) return 1;
+
+  TFile file(in_file_name.c_str(), "read");
+  TTree* tree(NULL);
+  file.GetObject("reduced_tree", tree);
+  if(tree==NULL){
+    std::cerr << "Error: Could not find tree reduced_tree in file " << in_file_name << '.' << std::endl;
+    return 1;
+  }
+  const ReducedTreeColumns columns(columns_file_name);
+  if(!columns.IsOpen()) return 1;
+
+  std::cout << "Cut: " << cut << std::endl;
+  std::cout << "Weight: " << weight << std::endl;
+  std::cout << "Events: " << columns.GetNumEntries() << std::endl;
+  std::cout << std::setw(32) << std::left << "Method" << std::right
+            << std::setw(16) << "Count" << std::setw(16) << "Uncertainty"
+            << std::setw(12) << "Time [s]" << std::setw(12) << "ns/event" << std::endl;
+
+  for(unsigned method(0); method<3; ++method){
+    double count(0.0), uncertainty(0.0);
+    const double start(GetWallTime());
+    std::string name("");
+    if(method==0){
+      name="get_count_and_uncertainty";
+      get_count_and_uncertainty(*tree, "("+cut+")*("+weight+")", count, uncertainty);
+    }else{
+      YieldCalculator yields(weight);
+      yields.AddRegion("benchmark", cut);
+      if(method==1){
+        name="YieldCalculator (TTree)";
+        yields.Fill(*tree);
+      }else{
+        name="YieldCalculator (columns)";
+        if(!yields.Fill(columns.GetFile())) return 1;
+      }
+      yields.GetCountAndUncertainty(0, count, uncertainty);
+    }
+    const double elapsed(GetWallTime()-start);
+    std::cout << std::setw(32) << std::left << name << std::right
+              << std::setw(16) << count << std::setw(16) << uncertainty
+              << std::setw(12) << elapsed
+              << std::setw(12) << (columns.GetNumEntries()?1.e9*elapsed/columns.GetNumEntries():0.0)
+              << std::endl;
+  }
+
+  file.Close();
+  return 0;
+}
@@ -0,0 +1,56 @@
+/*
+  Times the EventHandler selectors, variables and weights on synthetic events so that optimizations can be measured without cfA ntuples.
+  Input: none
+  Output: tab separated benchmark name, ns/event (timer overhead subtracted), raw ns/event, number of events and a checksum, one line per benchmark
+  Options:
+  -n: Number of events (default 100000)
+  -s: Sample name used for the sample dependent code paths (default TTJets_FullLeptMGDecays_8TeV-madgraph-tauola_Summer12_DR53X-PU_S10_START53_V7C-v2_AODSIM_UCSB1883_v71)
+  -r: Random seed (default 4357)
+  -o: Output file (default stdout)
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include "event_handler_benchmark.hpp"
+
+int main(int argc, char *argv[]){
+  std::string sample_name("TTJets_FullLeptMGDecays_8TeV-madgraph-tauola_Summer12_DR53X-PU_S10_START53_V7C-v2_AODSIM_UCSB1883_v71");
+  std::string out_file_name("");
+  unsigned num_events(100000), seed(4357);
+
+  int c(0);
+  while((c=getopt(argc, argv, "n:s:r:o:"))!=-1){
+    switch(c){
+    case 'n':
+      num_events=atoi(optarg);
+      break;
+    case 's':
+      sample_name=optarg;
+      break;
+    case 'r':
+      seed=atoi(optarg);
+      break;
+    case 'o':
+      out_file_name=optarg;
+      break;
+    default:
+      break;
+    }
+  }
+
+  EventHandlerBenchmark benchmark(sample_name, seed);
+  if(out_file_name==""){
+    benchmark.Run(num_events, std::cout);
+  }else{
+    std::ofstream out(out_file_name.c_str());
+    if(!out.is_open()){
+      std::cerr << "Error: Could not open " << out_file_name << " for writing." << std::endl;
+      return 1;
+    }
+    benchmark.Run(num_events, out);
+  }
+  return 0;
+}
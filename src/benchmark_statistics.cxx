@@ -0,0 +1,251 @@
+/*
+  Checks the Math statistics functions against the previous implementations and times them on a large synthetic sample.
+  Input: none
+  Output: value, difference from a reference and time for each method, and whether the methods agree. Exits with 1 if they do not.
+  Options:
+  -n: Number of values (default 100000000)
+  -j: Number of threads for the parallel RunningStats (default number of processors)
+  -s: Random seed (default 12345)
+*/
+
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include "math.hpp"
+
+namespace{
+  //Implementations before the streaming and selection based versions, kept to check the new ones
+  namespace reference{
+    template<typename T>
+    typename T::value_type Sum(T begin, T end){
+      typename T::value_type sum(0.0);
+      volatile typename T::value_type correction(0.0);
+      for(; begin!=end; ++begin){
+        const typename T::value_type corrected_val(*begin-correction);
+        const typename T::value_type temp_sum(sum+corrected_val);
+        correction=(temp_sum-sum)-corrected_val;
+        sum=temp_sum;
+      }
+      return sum;
+    }
+
+    template<typename T>
+    typename T::value_type Mean(T begin, T end){
+      return Sum(begin, end)/static_cast<typename T::value_type>(std::distance(begin,end));
+    }
+
+    template<typename T>
+    typename T::value_type Variance(T begin, T end){
+      const typename T::value_type mean(Mean(begin, end));
+      std::vector<typename T::value_type> residuals_squared(0);
+      for(T it(begin); it!=end; ++it){
+        const typename T::value_type residual(*it-mean);
+        residuals_squared.push_back(residual*residual);
+      }
+      return Sum(residuals_squared.begin(), residuals_squared.end())/static_cast<typename T::value_type>(std::distance(begin,end));
+    }
+
+    template<typename T>
+    typename T::value_type Median(T begin, T end){
+      std::sort(begin, end);
+      const typename T::difference_type separation(std::distance(begin, end));
+      end=begin;
+      std::advance(end, separation/2);
+      if(separation & 0x1ul){
+        return *end;
+      }else{
+        std::advance(begin, separation/2-1);
+        return 0.5*((*begin)+(*end));
+      }
+    }
+
+    template<typename T>
+    typename T::value_type HalfSampleMode(T begin, T end){
+      std::sort(begin, end);
+      const typename T::difference_type separation(std::distance(begin, end));
+      if(separation<=1){
+        return 0.5*((*begin)+(*end));
+      }else{
+        T inner_begin(begin), inner_end(begin);
+        std::advance(inner_end, (separation+1)/2);
+        typename T::value_type min_delta((*inner_end)-(*inner_begin));
+        T min_begin(inner_begin), min_end(inner_end);
+        ++inner_begin;
+        ++inner_end;
+        while(inner_end!=end){
+          const typename T::value_type this_delta((*inner_end)-(*inner_begin));
+          if(this_delta<min_delta){
+            min_delta=this_delta;
+            min_begin=inner_begin;
+            min_end=inner_end;
+          }
+          ++inner_begin;
+          ++inner_end;
+        }
+        return HalfSampleMode(min_begin, min_end);
+      }
+    }
+  }
+
+  struct Slice{
+    const double* begin;
+    const double* end;
+    Math::RunningStats stats;
+  };
+
+  void* RunSlice(void* arg){
+    Slice& slice(*static_cast<Slice*>(arg));
+    slice.stats.AddRange(slice.begin, slice.end);
+    return NULL;
+  }
+
+  double GetWallTime(){
+    timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec+1.e-6*now.tv_usec;
+  }
+
+  double Uniform(){
+    return (rand()+0.5)/(RAND_MAX+1.0);
+  }
+
+  void PrintRow(const std::string& name, const double value, const double expected, const double seconds){
+    std::cout << std::setw(36) << std::left << name << std::right
+              << std::setw(24) << std::setprecision(16) << value
+              << std::setw(14) << std::setprecision(3) << (expected!=0.0?(value-expected)/expected:value-expected)
+              << std::setw(12) << std::setprecision(4) << seconds << std::endl;
+  }
+
+  bool Agree(const double a, const double b, const double tolerance){
+    return fabs(a-b)<=tolerance*std::max(fabs(a), fabs(b));
+  }
+}
+
+int main(int argc, char *argv[]){
+  unsigned long num_values(100000000);
+  long num_threads(sysconf(_SC_NPROCESSORS_ONLN));
+  unsigned seed(12345);
+
+  int c(0);
+  while((c=getopt(argc, argv, "n:j:s:"))!=-1){
+    switch(c){
+    case 'n':
+      num_values=strtoul(optarg, NULL, 10);
+      break;
+    case 'j':
+      num_threads=atoi(optarg);
+      break;
+    case 's':
+      seed=atoi(optarg);
+      break;
+    default:
+      break;
+    }
+  }
+  if(num_threads<1) num_threads=1;
+  if(num_values<2) num_values=2;
+
+  //A narrow peak on a large offset, where naive sums lose precision, plus a flat background
+  std::cout << "Generating " << num_values << " values" << std::endl;
+  srand(seed);
+  std::vector<double> values(num_values);
+  for(std::size_t i(0); i<values.size(); ++i){
+    if(Uniform()<0.8){
+      values[i]=1.e6+sqrt(-2.0*log(Uniform()))*cos(2.0*Math::pi*Uniform());
+    }else{
+      values[i]=1.e6+100.0*(Uniform()-0.5);
+    }
+  }
+
+  long double exact_sum(0.0);
+  for(std::size_t i(0); i<values.size(); ++i) exact_sum+=values[i];
+  const double exact_mean(exact_sum/values.size());
+  long double exact_m2(0.0);
+  for(std::size_t i(0); i<values.size(); ++i) exact_m2+=(values[i]-exact_mean)*(values[i]-exact_mean);
+  const double exact_variance(exact_m2/values.size());
+
+  std::cout << std::setw(36) << std::left << "Method" << std::right << std::setw(24) << "Value"
+            << std::setw(14) << "Rel. diff" << std::setw(12) << "Time [s]" << std::endl;
+  bool good(true);
+  double start(0.0);
+
+  start=GetWallTime();
+  double naive_sum(0.0);
+  for(std::size_t i(0); i<values.size(); ++i) naive_sum+=values[i];
+  PrintRow("Sum (naive)", naive_sum, exact_sum, GetWallTime()-start);
+  start=GetWallTime();
+  const double old_sum(reference::Sum(values.begin(), values.end()));
+  PrintRow("Sum (previous Kahan)", old_sum, exact_sum, GetWallTime()-start);
+  start=GetWallTime();
+  const double new_sum(Math::Sum(values.begin(), values.end()));
+  PrintRow("Math::Sum", new_sum, exact_sum, GetWallTime()-start);
+  good=good && Agree(new_sum, static_cast<double>(exact_sum), 1.e-15);
+
+  start=GetWallTime();
+  const double old_variance(reference::Variance(values.begin(), values.end()));
+  PrintRow("Variance (previous)", old_variance, exact_variance, GetWallTime()-start);
+  start=GetWallTime();
+  const double new_variance(Math::Variance(values.begin(), values.end()));
+  PrintRow("Math::Variance", new_variance, exact_variance, GetWallTime()-start);
+  start=GetWallTime();
+  Math::RunningStats welford;
+  for(std::size_t i(0); i<values.size(); ++i) welford.Add(values[i]);
+  PrintRow("RunningStats::Add", welford.GetVariance(), exact_variance, GetWallTime()-start);
+  start=GetWallTime();
+  Math::RunningStats blocked;
+  blocked.AddRange(values.begin(), values.end());
+  PrintRow("RunningStats::AddRange", blocked.GetVariance(), exact_variance, GetWallTime()-start);
+
+  start=GetWallTime();
+  std::vector<Slice> slices(num_threads);
+  std::vector<pthread_t> threads(num_threads);
+  for(std::size_t thread(0); thread<threads.size(); ++thread){
+    slices.at(thread).begin=&values.at(0)+values.size()*thread/threads.size();
+    slices.at(thread).end=&values.at(0)+values.size()*(thread+1)/threads.size();
+    pthread_create(&threads.at(thread), NULL, RunSlice, &slices.at(thread));
+  }
+  Math::RunningStats parallel;
+  for(std::size_t thread(0); thread<threads.size(); ++thread){
+    pthread_join(threads.at(thread), NULL);
+    parallel.Add(slices.at(thread).stats);
+  }
+  std::ostringstream parallel_name("");
+  parallel_name << "RunningStats (" << num_threads << " threads)";
+  PrintRow(parallel_name.str(), parallel.GetVariance(), exact_variance, GetWallTime()-start);
+  good=good && Agree(new_variance, exact_variance, 1.e-9)
+    && Agree(welford.GetVariance(), exact_variance, 1.e-9)
+    && Agree(blocked.GetVariance(), exact_variance, 1.e-9)
+    && Agree(parallel.GetVariance(), exact_variance, 1.e-9)
+    && Agree(parallel.GetMean(), exact_mean, 1.e-15);
+
+  std::vector<double> scratch(values);
+  start=GetWallTime();
+  const double old_median(reference::Median(scratch.begin(), scratch.end()));
+  PrintRow("Median (previous, sort)", old_median, old_median, GetWallTime()-start);
+  scratch=values;
+  start=GetWallTime();
+  const double new_median(Math::Median(scratch.begin(), scratch.end()));
+  PrintRow("Math::Median", new_median, old_median, GetWallTime()-start);
+  good=good && new_median==old_median;
+
+  scratch=values;
+  start=GetWallTime();
+  const double old_mode(reference::HalfSampleMode(scratch.begin(), scratch.end()));
+  PrintRow("HalfSampleMode (previous)", old_mode, old_mode, GetWallTime()-start);
+  scratch=values;
+  start=GetWallTime();
+  const double new_mode(Math::HalfSampleMode(scratch.begin(), scratch.end()));
+  PrintRow("Math::HalfSampleMode", new_mode, old_mode, GetWallTime()-start);
+  good=good && new_mode==old_mode;
+
+  std::cout << (good?"All methods agree.":"Error: methods disagree.") << std::endl;
+  return good?0:1;
+}
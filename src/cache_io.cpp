@@ -0,0 +1,85 @@
+#include "cache_io.hpp"
+#include <cstdio>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/file.h>
+
+CacheHash::CacheHash():
+  hash_((static_cast<uint64_t>(0xcbf29ce4) << 32) | 0x84222325){
+}
+
+void CacheHash::Add(const void* data, const std::size_t size){
+  const uint64_t prime((static_cast<uint64_t>(0x100) << 32) | 0x1b3);
+  const unsigned char* const bytes(static_cast<const unsigned char*>(data));
+  for(std::size_t i(0); i<size; ++i){
+    hash_ ^= bytes[i];
+    hash_ *= prime;
+  }
+}
+
+void CacheHash::Add(const std::string& text){
+  Add(text.data(), text.size());
+}
+
+void CacheHash::AddByte(const unsigned char byte){
+  Add(&byte, 1);
+}
+
+uint64_t CacheHash::Get() const{
+  return hash_;
+}
+
+AtomicFileWriter::AtomicFileWriter(const std::string& file_name):
+  file_name_(file_name),
+  temp_name_(""),
+  stream_(),
+  committed_(false){
+  std::ostringstream temp_name("");
+  temp_name << file_name << '.' << getpid() << ".tmp";
+  temp_name_=temp_name.str();
+  stream_.open(temp_name_.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+}
+
+AtomicFileWriter::~AtomicFileWriter(){
+  if(committed_) return;
+  if(stream_.is_open()) stream_.close();
+  remove(temp_name_.c_str());
+}
+
+std::ofstream& AtomicFileWriter::GetStream(){
+  return stream_;
+}
+
+bool AtomicFileWriter::Commit(){
+  if(committed_) return true;
+  if(!stream_.is_open()) return false;
+  stream_.close();
+  if(stream_.fail() || rename(temp_name_.c_str(), file_name_.c_str())!=0){
+    remove(temp_name_.c_str());
+    return false;
+  }
+  committed_=true;
+  return true;
+}
+
+FileLock::FileLock(const std::string& lock_name):
+  fd_(open(lock_name.c_str(), O_RDWR | O_CREAT, 0644)){
+  if(fd_>=0 && flock(fd_, LOCK_EX)!=0){
+    close(fd_);
+    fd_=-1;
+  }
+}
+
+FileLock::~FileLock(){
+  if(fd_<0) return;
+  flock(fd_, LOCK_UN);
+  close(fd_);
+}
+
+bool FileLock::IsLocked() const{
+  return fd_>=0;
+}
@@ -0,0 +1,402 @@
+#include "cfa_cache.hpp"
+#include <vector>
+#include <string>
+#include <set>
+#include <sstream>
+#include <stdint.h>
+#include "cfa_branch_visitor.hpp"
+#include "columnar_file.hpp"
+
+namespace{
+  template<typename T>
+  void WriteValue(ColumnarWriter& writer, const unsigned column, const unsigned, const T& value){
+    writer.Append(column, &value, 1);
+  }
+
+  void WriteValue(ColumnarWriter& writer, const unsigned column, const unsigned, const bool& value){
+    const uint8_t stored(value);
+    writer.Append(column, &stored, 1);
+  }
+
+  void WriteValue(ColumnarWriter& writer, const unsigned column, const unsigned level, const std::string& value){
+    writer.Append(column, value.data(), value.size());
+    writer.EndList(column, level);
+  }
+
+  void WriteValue(ColumnarWriter& writer, const unsigned column, const unsigned level, const std::vector<float>& value){
+    if(value.size()) writer.Append(column, &value.at(0), value.size());
+    writer.EndList(column, level);
+  }
+
+  void WriteValue(ColumnarWriter& writer, const unsigned column, const unsigned level, const std::vector<int>& value){
+    if(value.size()) writer.Append(column, &value.at(0), value.size());
+    writer.EndList(column, level);
+  }
+
+  void WriteValue(ColumnarWriter& writer, const unsigned column, const unsigned level, const std::vector<bool>& value){
+    for(std::vector<bool>::size_type i(0); i<value.size(); ++i){
+      WriteValue(writer, column, level+1, static_cast<bool>(value[i]));
+    }
+    writer.EndList(column, level);
+  }
+
+  template<typename T>
+  void WriteValue(ColumnarWriter& writer, const unsigned column, const unsigned level, const std::vector<T>& value){
+    for(typename std::vector<T>::size_type i(0); i<value.size(); ++i){
+      WriteValue(writer, column, level+1, value[i]);
+    }
+    writer.EndList(column, level);
+  }
+
+  template<typename T>
+  void WriteValue(ColumnarWriter& writer, const unsigned column, const unsigned level, T* const& value){
+    //ROOT leaves the pointer NULL for branches missing from the current file
+    if(value!=NULL){
+      WriteValue(writer, column, level, *value);
+    }else{
+      WriteValue(writer, column, level, T());
+    }
+  }
+
+  //Elements removed when a container shrinks are kept here instead of being
+  //destroyed, so their heap storage is reused when the container grows again.
+  template<typename T>
+  class ElementPool{
+  public:
+    ElementPool():
+      spare_(0){
+    }
+
+    void Resize(std::vector<T>& values, const std::size_t size){
+      while(values.size()>size){
+        spare_.push_back(T());
+        spare_.back().swap(values.back());
+        values.pop_back();
+      }
+      while(values.size()<size){
+        values.push_back(T());
+        if(spare_.size()){
+          values.back().swap(spare_.back());
+          spare_.pop_back();
+        }
+      }
+    }
+
+  private:
+    std::vector<T> spare_;
+  };
+
+  //Per-binding state needed to read a value without allocating. Scalars,
+  //strings and flat vectors keep their capacity on their own; nested vectors
+  //need a pool for each level.
+  template<typename T>
+  struct ReadPool{
+  };
+
+  template<typename T>
+  struct ReadPool<std::vector<T> >{
+    ElementPool<T> elements;
+    ReadPool<T> inner;
+  };
+
+  template<> struct ReadPool<std::vector<float> >{};
+  template<> struct ReadPool<std::vector<int> >{};
+  template<> struct ReadPool<std::vector<bool> >{};
+
+  template<typename T>
+  void ReadValue(const ColumnarColumn& column, const unsigned, const uint64_t index, T& value, ReadPool<T>&){
+    value=static_cast<const T*>(column.values)[index];
+  }
+
+  void ReadValue(const ColumnarColumn& column, const unsigned, const uint64_t index, bool& value, ReadPool<bool>&){
+    value=static_cast<const uint8_t*>(column.values)[index]!=0;
+  }
+
+  void ReadValue(const ColumnarColumn& column, const unsigned level, const uint64_t index, std::string& value,
+                 ReadPool<std::string>&){
+    const char* chars(static_cast<const char*>(column.values));
+    value.assign(chars+column.offsets[level][index], chars+column.offsets[level][index+1]);
+  }
+
+  void ReadValue(const ColumnarColumn& column, const unsigned level, const uint64_t index, std::vector<float>& value,
+                 ReadPool<std::vector<float> >&){
+    const float* values(static_cast<const float*>(column.values));
+    value.assign(values+column.offsets[level][index], values+column.offsets[level][index+1]);
+  }
+
+  void ReadValue(const ColumnarColumn& column, const unsigned level, const uint64_t index, std::vector<int>& value,
+                 ReadPool<std::vector<int> >&){
+    const int* values(static_cast<const int*>(column.values));
+    value.assign(values+column.offsets[level][index], values+column.offsets[level][index+1]);
+  }
+
+  void ReadValue(const ColumnarColumn& column, const unsigned level, const uint64_t index, std::vector<bool>& value,
+                 ReadPool<std::vector<bool> >&){
+    const uint8_t* values(static_cast<const uint8_t*>(column.values));
+    const uint64_t begin(column.offsets[level][index]), end(column.offsets[level][index+1]);
+    value.resize(end-begin);
+    for(uint64_t i(begin); i<end; ++i){
+      value[i-begin]=values[i]!=0;
+    }
+  }
+
+  template<typename T>
+  void ReadValue(const ColumnarColumn& column, const unsigned level, const uint64_t index, std::vector<T>& value,
+                 ReadPool<std::vector<T> >& pool){
+    const uint64_t begin(column.offsets[level][index]), end(column.offsets[level][index+1]);
+    pool.elements.Resize(value, end-begin);
+    for(uint64_t i(begin); i<end; ++i){
+      ReadValue(column, level+1, i, value[i-begin], pool.inner);
+    }
+  }
+
+  uint64_t GetEntryBytes(const ColumnarColumn& column, const uint64_t index){
+    //Size of the leaf values belonging to one entry, as ROOT would count for GetEntry
+    uint64_t begin(index), end(index+1);
+    for(unsigned level(0); level<column.depth; ++level){
+      begin=column.offsets[level][begin];
+      end=column.offsets[level][end];
+    }
+    return (end-begin)*GetColumnTypeSize(column.type);
+  }
+
+  template<typename T>
+  class CfaWriteBinding : public CfaCacheBinding{
+  public:
+    CfaWriteBinding(T& member, const unsigned column):
+      member_(member),
+      column_(column){
+    }
+
+    void Write(ColumnarWriter& writer){
+      WriteValue(writer, column_, 0, member_);
+    }
+
+    uint64_t Read(const uint64_t){
+      return 0;
+    }
+
+  private:
+    T& member_;
+    const unsigned column_;
+  };
+
+  template<typename T>
+  class CfaReadBinding : public CfaCacheBinding{
+  public:
+    CfaReadBinding(T& member, const ColumnarColumn* column):
+      member_(member),
+      column_(column),
+      pool_(){
+    }
+
+    void Write(ColumnarWriter&){
+    }
+
+    uint64_t Read(const uint64_t entry){
+      if(column_==NULL) return 0;
+      ReadValue(*column_, 0, entry, member_, pool_);
+      return GetEntryBytes(*column_, entry);
+    }
+
+  private:
+    T& member_;
+    const ColumnarColumn* column_;
+    ReadPool<T> pool_;
+  };
+
+  template<typename T>
+  class CfaReadBinding<T*> : public CfaCacheBinding{
+  public:
+    //Values are read into the container owned by the cfA object. If there is
+    //none, the binding provides one, so branches absent from the cache are
+    //left as empty containers rather than NULL.
+    CfaReadBinding(T*& member, const ColumnarColumn* column):
+      value_(),
+      target_(member),
+      column_(column),
+      pool_(){
+      if(member==NULL) member=&value_;
+      target_=member;
+    }
+
+    void Write(ColumnarWriter&){
+    }
+
+    uint64_t Read(const uint64_t entry){
+      if(column_==NULL) return 0;
+      ReadValue(*column_, 0, entry, *target_, pool_);
+      return GetEntryBytes(*column_, entry);
+    }
+
+  private:
+    T value_;
+    T* target_;
+    const ColumnarColumn* column_;
+    ReadPool<T> pool_;
+  };
+}
+
+CfaBranchVisitor::~CfaBranchVisitor(){
+}
+
+CfaCacheBinding::~CfaCacheBinding(){
+}
+
+bool IsCfaCacheFile(const std::string& file_name){
+  const std::string extension(".cfacache");
+  return file_name.size()>=extension.size()
+    && file_name.compare(file_name.size()-extension.size(), extension.size(), extension)==0;
+}
+
+CfaCacheWriter::CfaCacheWriter(const std::string& path, const std::set<std::string>& branches):
+  writer_(path),
+  branches_(branches),
+  bound_branches_(0),
+  bindings_(0){
+}
+
+CfaCacheWriter::~CfaCacheWriter(){
+  for(std::vector<CfaCacheBinding*>::iterator it(bindings_.begin());
+      it!=bindings_.end(); ++it){
+    delete *it;
+  }
+}
+
+bool CfaCacheWriter::IsOpen() const{
+  return writer_.IsOpen();
+}
+
+const std::vector<std::string>& CfaCacheWriter::GetBoundBranches() const{
+  return bound_branches_;
+}
+
+void CfaCacheWriter::Fill(){
+  for(std::vector<CfaCacheBinding*>::iterator it(bindings_.begin());
+      it!=bindings_.end(); ++it){
+    (*it)->Write(writer_);
+  }
+  writer_.EndEntry();
+}
+
+void CfaCacheWriter::SetMetadata(const std::string& key, const std::string& value){
+  writer_.SetMetadata(key, value);
+}
+
+bool CfaCacheWriter::Close(){
+  //The header lists the branches, so a reader can tell a cache made for an
+  //older cfA class from one that has every branch it needs
+  std::ostringstream branches("");
+  for(std::size_t branch(0); branch<bound_branches_.size(); ++branch){
+    if(branch!=0) branches << ' ';
+    branches << bound_branches_.at(branch);
+  }
+  writer_.SetMetadata("branches", branches.str());
+  return writer_.Close();
+}
+
+uint64_t CfaCacheWriter::GetBytesWritten() const{
+  return writer_.GetBytesWritten();
+}
+
+template<typename T>
+void CfaCacheWriter::Bind(const std::string& name, T& member){
+  if(branches_.find(name)==branches_.end()) return;
+  const unsigned column(writer_.AddColumn(name, ColumnTraits<T>::type, ColumnTraits<T>::depth));
+  bindings_.push_back(new CfaWriteBinding<T>(member, column));
+  bound_branches_.push_back(name);
+}
+
+void CfaCacheWriter::Visit(const std::string& name, bool& member){Bind(name, member);}
+void CfaCacheWriter::Visit(const std::string& name, int& member){Bind(name, member);}
+void CfaCacheWriter::Visit(const std::string& name, unsigned& member){Bind(name, member);}
+void CfaCacheWriter::Visit(const std::string& name, float& member){Bind(name, member);}
+void CfaCacheWriter::Visit(const std::string& name, double& member){Bind(name, member);}
+void CfaCacheWriter::Visit(const std::string& name, std::string*& member){Bind(name, member);}
+void CfaCacheWriter::Visit(const std::string& name, std::vector<bool>*& member){Bind(name, member);}
+void CfaCacheWriter::Visit(const std::string& name, std::vector<int>*& member){Bind(name, member);}
+void CfaCacheWriter::Visit(const std::string& name, std::vector<float>*& member){Bind(name, member);}
+void CfaCacheWriter::Visit(const std::string& name, std::vector<std::string>*& member){Bind(name, member);}
+void CfaCacheWriter::Visit(const std::string& name, std::vector<std::vector<int> >*& member){Bind(name, member);}
+void CfaCacheWriter::Visit(const std::string& name, std::vector<std::vector<float> >*& member){Bind(name, member);}
+void CfaCacheWriter::Visit(const std::string& name, std::vector<std::vector<std::string> >*& member){Bind(name, member);}
+
+CfaCacheReader::CfaCacheReader(const std::string& path):
+  file_(path),
+  branches_(),
+  missing_branches_(0),
+  bindings_(0){
+  std::istringstream branches(file_.GetMetadata("branches"));
+  std::string branch("");
+  while(branches >> branch) branches_.insert(branch);
+}
+
+CfaCacheReader::~CfaCacheReader(){
+  for(std::vector<CfaCacheBinding*>::iterator it(bindings_.begin());
+      it!=bindings_.end(); ++it){
+    delete *it;
+  }
+}
+
+bool CfaCacheReader::IsOpen() const{
+  return file_.IsOpen();
+}
+
+int CfaCacheReader::GetNumEntries() const{
+  return file_.IsOpen()?static_cast<int>(file_.GetNumEntries()):-1;
+}
+
+std::string CfaCacheReader::GetSampleName() const{
+  return file_.GetMetadata("sample_name");
+}
+
+const ColumnarFile& CfaCacheReader::GetFile() const{
+  return file_;
+}
+
+bool CfaCacheReader::IsComplete() const{
+  return file_.IsOpen() && missing_branches_.size()==0;
+}
+
+const std::vector<std::string>& CfaCacheReader::GetMissingBranches() const{
+  return missing_branches_;
+}
+
+int CfaCacheReader::GetEntry(const unsigned int entry){
+  //Like TTree::GetEntry, returns the number of bytes read
+  if(entry>=file_.GetNumEntries()) return 0;
+  uint64_t bytes(0);
+  for(std::vector<CfaCacheBinding*>::iterator it(bindings_.begin());
+      it!=bindings_.end(); ++it){
+    bytes+=(*it)->Read(entry);
+  }
+  return bytes>0?static_cast<int>(bytes):1;
+}
+
+template<typename T>
+void CfaCacheReader::Bind(const std::string& name, T& member){
+  //Only branches listed in the header count, so caches written before the list
+  //was stored are treated as missing everything and must be remade. Mismatches
+  //are only collected; the caller decides whether they are worth reporting.
+  const ColumnarColumn* column(branches_.find(name)!=branches_.end()?file_.GetColumn(name):NULL);
+  if(column!=NULL
+     && (column->type!=ColumnTraits<T>::type || column->depth!=ColumnTraits<T>::depth)){
+    column=NULL;
+  }
+  if(column==NULL) missing_branches_.push_back(name);
+  bindings_.push_back(new CfaReadBinding<T>(member, column));
+}
+
+void CfaCacheReader::Visit(const std::string& name, bool& member){Bind(name, member);}
+void CfaCacheReader::Visit(const std::string& name, int& member){Bind(name, member);}
+void CfaCacheReader::Visit(const std::string& name, unsigned& member){Bind(name, member);}
+void CfaCacheReader::Visit(const std::string& name, float& member){Bind(name, member);}
+void CfaCacheReader::Visit(const std::string& name, double& member){Bind(name, member);}
+void CfaCacheReader::Visit(const std::string& name, std::string*& member){Bind(name, member);}
+void CfaCacheReader::Visit(const std::string& name, std::vector<bool>*& member){Bind(name, member);}
+void CfaCacheReader::Visit(const std::string& name, std::vector<int>*& member){Bind(name, member);}
+void CfaCacheReader::Visit(const std::string& name, std::vector<float>*& member){Bind(name, member);}
+void CfaCacheReader::Visit(const std::string& name, std::vector<std::string>*& member){Bind(name, member);}
+void CfaCacheReader::Visit(const std::string& name, std::vector<std::vector<int> >*& member){Bind(name, member);}
+void CfaCacheReader::Visit(const std::string& name, std::vector<std::vector<float> >*& member){Bind(name, member);}
+void CfaCacheReader::Visit(const std::string& name, std::vector<std::vector<std::string> >*& member){Bind(name, member);}
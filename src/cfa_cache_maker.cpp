@@ -0,0 +1,101 @@
+#include "cfa_cache_maker.hpp"
+#include <vector>
+#include <string>
+#include <set>
+#include <fstream>
+#include <iostream>
+#include "cfa.hpp"
+#include "cfa_cache.hpp"
+#include "timer.hpp"
+#include "cfa_branch_visitor.hpp"
+
+namespace{
+  class BranchNameCollector : public CfaBranchVisitor{
+  public:
+    BranchNameCollector():
+      names_(){
+    }
+
+    const std::set<std::string>& GetNames() const{return names_;}
+
+    void Visit(const std::string& name, bool&){names_.insert(name);}
+    void Visit(const std::string& name, int&){names_.insert(name);}
+    void Visit(const std::string& name, unsigned&){names_.insert(name);}
+    void Visit(const std::string& name, float&){names_.insert(name);}
+    void Visit(const std::string& name, double&){names_.insert(name);}
+    void Visit(const std::string& name, std::string*&){names_.insert(name);}
+    void Visit(const std::string& name, std::vector<bool>*&){names_.insert(name);}
+    void Visit(const std::string& name, std::vector<int>*&){names_.insert(name);}
+    void Visit(const std::string& name, std::vector<float>*&){names_.insert(name);}
+    void Visit(const std::string& name, std::vector<std::string>*&){names_.insert(name);}
+    void Visit(const std::string& name, std::vector<std::vector<int> >*&){names_.insert(name);}
+    void Visit(const std::string& name, std::vector<std::vector<float> >*&){names_.insert(name);}
+    void Visit(const std::string& name, std::vector<std::vector<std::string> >*&){names_.insert(name);}
+
+  private:
+    std::set<std::string> names_;
+  };
+}
+
+CfaCacheMaker::CfaCacheMaker(const std::string& in_file_name,
+                             const bool is_list):
+  cfA(in_file_name, is_list){
+}
+
+bool CfaCacheMaker::MakeCache(const std::string& out_file_name,
+                              const std::set<std::string>& branches){
+  chainA.SetBranchStatus("*",0);
+  chainB.SetBranchStatus("*",0);
+  for(std::set<std::string>::const_iterator branch(branches.begin());
+      branch!=branches.end(); ++branch){
+    if(chainA.GetBranch(branch->c_str())!=NULL){
+      chainA.SetBranchStatus(branch->c_str(),1);
+    }else if(chainB.GetBranch(branch->c_str())!=NULL){
+      chainB.SetBranchStatus(branch->c_str(),1);
+    }else{
+      std::cerr << "Warning: branch " << *branch << " not found in " << sampleName << '.' << std::endl;
+    }
+  }
+
+  CfaCacheWriter writer(out_file_name, branches);
+  VisitBranches(writer);
+  writer.SetMetadata("sample_name", sampleName);
+
+  Timer timer(GetTotalEntries());
+  timer.Start();
+  for(int i(0); i<GetTotalEntries(); ++i){
+    if(i%1000==0 && i!=0){
+      timer.PrintRemainingTime();
+    }
+    timer.Iterate();
+    GetEntry(i);
+    writer.Fill();
+  }
+
+  const bool success(writer.Close());
+  if(success){
+    std::cout << "Wrote " << writer.GetBoundBranches().size() << " branches for "
+              << GetTotalEntries() << " entries (" << writer.GetBytesWritten()
+              << " bytes) to " << out_file_name << '.' << std::endl;
+  }
+  return success;
+}
+
+std::set<std::string> CfaCacheMaker::GetDefaultBranches(){
+  //The generated class only has members for the branches EventHandler and
+  //ReducedTreeMaker read, so its branches are exactly the ones to cache
+  BranchNameCollector collector;
+  VisitBranches(collector);
+  return collector.GetNames();
+}
+
+std::set<std::string> CfaCacheMaker::ReadBranchList(const std::string& file_name){
+  std::set<std::string> branches;
+  std::ifstream infile(file_name.c_str());
+  std::string branch("");
+  while(infile >> branch){
+    branches.insert(branch);
+  }
+  infile.close();
+  return branches;
+}
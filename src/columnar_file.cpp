@@ -0,0 +1,389 @@
+#include "columnar_file.hpp"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace{
+  const char magic[8]={'S','L','S','C','O','L','0','1'};
+  const uint64_t alignment(64);
+
+  uint64_t Align(const uint64_t position){
+    return ((position+alignment-1)/alignment)*alignment;
+  }
+
+  template<typename T>
+  void Put(std::string& buffer, const T& value){
+    buffer.append(static_cast<const char*>(static_cast<const void*>(&value)), sizeof(T));
+  }
+
+  void PutString(std::string& buffer, const std::string& value){
+    Put(buffer, static_cast<uint32_t>(value.size()));
+    buffer.append(value);
+  }
+
+  template<typename T>
+  bool Get(const char*& position, const char* end, T& value){
+    if(static_cast<std::size_t>(end-position)<sizeof(T)) return false;
+    memcpy(&value, position, sizeof(T));
+    position+=sizeof(T);
+    return true;
+  }
+
+  bool GetString(const char*& position, const char* end, std::string& value){
+    uint32_t length(0);
+    if(!Get(position, end, length) || static_cast<uint64_t>(end-position)<length) return false;
+    value.assign(position, length);
+    position+=length;
+    return true;
+  }
+
+  bool CopyStream(FILE* from, FILE* to, uint64_t& position){
+    char buffer[1<<16];
+    rewind(from);
+    std::size_t num_read(0);
+    while((num_read=fread(buffer, 1, sizeof(buffer), from))>0){
+      if(fwrite(buffer, 1, num_read, to)!=num_read) return false;
+      position+=num_read;
+    }
+    return !ferror(from);
+  }
+
+  bool Pad(FILE* to, uint64_t& position){
+    const char zeros[alignment]={0};
+    const std::size_t padding(Align(position)-position);
+    if(padding>0 && fwrite(zeros, 1, padding, to)!=padding) return false;
+    position+=padding;
+    return true;
+  }
+
+  bool TakeSection(const uint64_t position, const uint64_t count, const uint64_t item_size,
+                   const uint64_t file_size, uint64_t& next_free){
+    //Sections are written back to back in header order, so each one must start
+    //at or after the end of the one before it
+    if(position%alignment!=0 || position<next_free || position>file_size
+       || count>(file_size-position)/item_size) return false;
+    next_free=position+count*item_size;
+    return true;
+  }
+}
+
+size_t GetColumnTypeSize(const ColumnType type){
+  switch(type){
+  case kColumnBool: return sizeof(uint8_t);
+  case kColumnChar: return sizeof(char);
+  case kColumnUInt8: return sizeof(uint8_t);
+  case kColumnInt16: return sizeof(int16_t);
+  case kColumnUInt16: return sizeof(uint16_t);
+  case kColumnInt32: return sizeof(int32_t);
+  case kColumnUInt32: return sizeof(uint32_t);
+  case kColumnFloat: return sizeof(float);
+  case kColumnDouble: return sizeof(double);
+  default: return 0;
+  }
+}
+
+ColumnarWriter::ColumnarWriter(const std::string& path):
+  path_(path),
+  columns_(0),
+  metadata_(),
+  num_entries_(0),
+  bytes_written_(0),
+  open_(true),
+  good_(true){
+}
+
+ColumnarWriter::~ColumnarWriter(){
+  if(open_) Close();
+}
+
+bool ColumnarWriter::IsOpen() const{
+  return open_ && good_;
+}
+
+unsigned ColumnarWriter::AddColumn(const std::string& name, const ColumnType type, const unsigned depth){
+  if(num_entries_!=0){
+    std::cerr << "Error: cannot add column " << name << " to " << path_ << " after entries have been written." << std::endl;
+    good_=false;
+  }
+  if(depth>ColumnarColumn::max_depth){
+    std::cerr << "Error: column " << name << " is nested deeper than supported." << std::endl;
+    good_=false;
+  }
+  PendingColumn column;
+  column.name=name;
+  column.type=type;
+  column.depth=depth;
+  column.values.file=tmpfile();
+  column.values.count=0;
+  if(column.values.file==NULL) good_=false;
+  for(unsigned level(0); level<ColumnarColumn::max_depth; ++level){
+    column.offsets[level].file=NULL;
+    column.offsets[level].count=0;
+    if(level<depth){
+      column.offsets[level].file=tmpfile();
+      if(column.offsets[level].file==NULL){
+        good_=false;
+      }else{
+        WriteOffset(column.offsets[level], 0);
+      }
+    }
+  }
+  columns_.push_back(column);
+  return columns_.size()-1;
+}
+
+void ColumnarWriter::SetMetadata(const std::string& key, const std::string& value){
+  metadata_[key]=value;
+}
+
+void ColumnarWriter::Append(const unsigned column, const void* values, const uint64_t num_values){
+  Stream& stream(columns_.at(column).values);
+  const std::size_t size(GetColumnTypeSize(columns_.at(column).type));
+  if(num_values>0 && fwrite(values, size, num_values, stream.file)!=num_values) good_=false;
+  stream.count+=num_values;
+}
+
+void ColumnarWriter::EndList(const unsigned column, const unsigned level){
+  //Closes the current list at the given level. Its end offset is the number of
+  //items written so far one level further in (or the number of leaf values).
+  PendingColumn& this_column(columns_.at(column));
+  const uint64_t end(level+1<this_column.depth
+                     ?this_column.offsets[level+1].count-1
+                     :this_column.values.count);
+  WriteOffset(this_column.offsets[level], end);
+}
+
+void ColumnarWriter::EndEntry(){
+  ++num_entries_;
+}
+
+uint64_t ColumnarWriter::GetNumEntries() const{
+  return num_entries_;
+}
+
+uint64_t ColumnarWriter::GetBytesWritten() const{
+  return bytes_written_;
+}
+
+void ColumnarWriter::WriteOffset(Stream& stream, const uint64_t offset){
+  if(fwrite(&offset, sizeof(offset), 1, stream.file)!=1) good_=false;
+  ++stream.count;
+}
+
+void ColumnarWriter::CloseStreams(){
+  for(std::vector<PendingColumn>::iterator column(columns_.begin());
+      column!=columns_.end(); ++column){
+    if(column->values.file!=NULL) fclose(column->values.file);
+    column->values.file=NULL;
+    for(unsigned level(0); level<ColumnarColumn::max_depth; ++level){
+      if(column->offsets[level].file!=NULL) fclose(column->offsets[level].file);
+      column->offsets[level].file=NULL;
+    }
+  }
+}
+
+bool ColumnarWriter::Close(){
+  if(!open_) return good_;
+  open_=false;
+
+  for(std::vector<PendingColumn>::const_iterator column(columns_.begin());
+      column!=columns_.end(); ++column){
+    const uint64_t entries(column->depth==0?column->values.count:column->offsets[0].count-1);
+    if(entries!=num_entries_){
+      std::cerr << "Error: column " << column->name << " has " << entries
+                << " entries, expected " << num_entries_ << '.' << std::endl;
+      good_=false;
+    }
+  }
+  if(!good_){
+    CloseStreams();
+    return false;
+  }
+
+  //The header has a fixed size for a given set of columns, so build it once with
+  //dummy offsets to learn its length and then again with the real data layout.
+  std::string header("");
+  for(unsigned pass(0); pass<2; ++pass){
+    uint64_t position(Align(header.size()));
+    header.clear();
+    header.append(magic, sizeof(magic));
+    Put(header, num_entries_);
+    Put(header, static_cast<uint32_t>(columns_.size()));
+    Put(header, static_cast<uint32_t>(metadata_.size()));
+    for(std::map<std::string, std::string>::const_iterator it(metadata_.begin());
+        it!=metadata_.end(); ++it){
+      PutString(header, it->first);
+      PutString(header, it->second);
+    }
+    for(std::vector<PendingColumn>::const_iterator column(columns_.begin());
+        column!=columns_.end(); ++column){
+      PutString(header, column->name);
+      Put(header, static_cast<uint32_t>(column->type));
+      Put(header, static_cast<uint32_t>(column->depth));
+      Put(header, column->values.count);
+      Put(header, position);
+      position=Align(position+column->values.count*GetColumnTypeSize(column->type));
+      for(unsigned level(0); level<column->depth; ++level){
+        Put(header, column->offsets[level].count);
+        Put(header, position);
+        position=Align(position+column->offsets[level].count*sizeof(uint64_t));
+      }
+    }
+  }
+
+  FILE* out(fopen(path_.c_str(), "wb"));
+  if(out==NULL){
+    std::cerr << "Error: could not open " << path_ << " for writing." << std::endl;
+    CloseStreams();
+    good_=false;
+    return false;
+  }
+  uint64_t position(0);
+  good_=fwrite(header.data(), 1, header.size(), out)==header.size();
+  position+=header.size();
+  for(std::vector<PendingColumn>::const_iterator column(columns_.begin());
+      good_ && column!=columns_.end(); ++column){
+    good_=Pad(out, position) && CopyStream(column->values.file, out, position);
+    for(unsigned level(0); good_ && level<column->depth; ++level){
+      good_=Pad(out, position) && CopyStream(column->offsets[level].file, out, position);
+    }
+  }
+  good_=Pad(out, position) && good_;
+  if(fclose(out)!=0) good_=false;
+  CloseStreams();
+  bytes_written_=position;
+  if(!good_) std::cerr << "Error: failed writing " << path_ << '.' << std::endl;
+  return good_;
+}
+
+ColumnarFile::ColumnarFile(const std::string& path):
+  map_(NULL),
+  size_(0),
+  num_entries_(0),
+  columns_(0),
+  column_index_(),
+  metadata_(){
+  const int fd(open(path.c_str(), O_RDONLY));
+  if(fd<0){
+    std::cerr << "Error: could not open " << path << '.' << std::endl;
+    return;
+  }
+  struct stat file_stat;
+  if(fstat(fd, &file_stat)==0 && file_stat.st_size>0){
+    size_=file_stat.st_size;
+    map_=mmap(NULL, size_, PROT_READ, MAP_SHARED, fd, 0);
+    if(map_==MAP_FAILED) map_=NULL;
+  }
+  close(fd);
+  if(map_==NULL || !Parse()){
+    std::cerr << "Error: " << path << " is not a valid columnar file." << std::endl;
+    if(map_!=NULL) munmap(map_, size_);
+    map_=NULL;
+    columns_.clear();
+    column_index_.clear();
+    metadata_.clear();
+  }
+}
+
+ColumnarFile::~ColumnarFile(){
+  if(map_!=NULL) munmap(map_, size_);
+}
+
+bool ColumnarFile::IsOpen() const{
+  return map_!=NULL;
+}
+
+uint64_t ColumnarFile::GetNumEntries() const{
+  return num_entries_;
+}
+
+uint64_t ColumnarFile::GetFileSize() const{
+  return size_;
+}
+
+const std::vector<ColumnarColumn>& ColumnarFile::GetColumns() const{
+  return columns_;
+}
+
+const ColumnarColumn* ColumnarFile::GetColumn(const std::string& name) const{
+  const std::map<std::string, std::size_t>::const_iterator it(column_index_.find(name));
+  return it==column_index_.end()?NULL:&columns_.at(it->second);
+}
+
+bool ColumnarFile::HasMetadata(const std::string& key) const{
+  return metadata_.find(key)!=metadata_.end();
+}
+
+std::string ColumnarFile::GetMetadata(const std::string& key) const{
+  const std::map<std::string, std::string>::const_iterator it(metadata_.find(key));
+  return it==metadata_.end()?"":it->second;
+}
+
+bool ColumnarFile::Parse(){
+  const char* begin(static_cast<const char*>(map_));
+  const char* end(begin+size_);
+  const char* position(begin);
+  if(size_<sizeof(magic) || memcmp(begin, magic, sizeof(magic))!=0) return false;
+  position+=sizeof(magic);
+
+  uint32_t num_columns(0), num_metadata(0);
+  if(!Get(position, end, num_entries_)
+     || !Get(position, end, num_columns)
+     || !Get(position, end, num_metadata)) return false;
+  for(uint32_t i(0); i<num_metadata; ++i){
+    std::string key(""), value("");
+    if(!GetString(position, end, key) || !GetString(position, end, value)) return false;
+    metadata_[key]=value;
+  }
+  uint64_t first_section(size_), next_free(0);
+  for(uint32_t i(0); i<num_columns; ++i){
+    ColumnarColumn column;
+    uint32_t type(0), depth(0);
+    uint64_t values_position(0);
+    if(!GetString(position, end, column.name)
+       || !Get(position, end, type)
+       || !Get(position, end, depth)
+       || !Get(position, end, column.num_values)
+       || !Get(position, end, values_position)) return false;
+    if(type>kColumnDouble || depth>ColumnarColumn::max_depth) return false;
+    column.type=static_cast<ColumnType>(type);
+    column.depth=depth;
+    if(!TakeSection(values_position, column.num_values, GetColumnTypeSize(column.type),
+                    size_, next_free)) return false;
+    if(i==0) first_section=values_position;
+    column.values=begin+values_position;
+    for(unsigned level(0); level<ColumnarColumn::max_depth; ++level){
+      column.num_offsets[level]=0;
+      column.offsets[level]=NULL;
+      if(level>=depth) continue;
+      uint64_t offsets_position(0);
+      if(!Get(position, end, column.num_offsets[level])
+         || !Get(position, end, offsets_position)) return false;
+      if(!TakeSection(offsets_position, column.num_offsets[level], sizeof(uint64_t),
+                      size_, next_free)) return false;
+      column.offsets[level]=static_cast<const uint64_t*>(static_cast<const void*>(begin+offsets_position));
+    }
+    if(depth==0 && column.num_values!=num_entries_) return false;
+    if(depth>0 && column.num_offsets[0]!=num_entries_+1) return false;
+    for(unsigned level(0); level<depth; ++level){
+      const uint64_t num_items(level+1<depth?column.num_offsets[level+1]-1:column.num_values);
+      const uint64_t* const offsets(column.offsets[level]);
+      if(column.num_offsets[level]==0 || offsets[0]!=0
+         || offsets[column.num_offsets[level]-1]>num_items) return false;
+      for(uint64_t offset(1); offset<column.num_offsets[level]; ++offset){
+        if(offsets[offset]<offsets[offset-1]) return false;
+      }
+    }
+    column_index_[column.name]=columns_.size();
+    columns_.push_back(column);
+  }
+  return first_section>=static_cast<uint64_t>(position-begin);
+}
@@ -0,0 +1,443 @@
+/*
+  Compares two reduced_tree files event by event to check that a change to the reduced tree production does not change its output. Events are matched on (run, lumiblock, event), so the two files may be in different orders.
+  Input: reference and candidate reduced_tree files given with -a and -b. Both are read through their columnar copies (see export_reduced_tree.exe), which are made automatically if missing or out of date.
+  Output: missing and extra events, branches present in only one file and, for every common branch, the number of mismatched events, the largest absolute and relative differences and the means in both files. Exits with 0 if the files agree, 2 if they differ and 1 on errors.
+  Options:
+  -a: Reference reduced_tree file
+  -b: Candidate reduced_tree file
+  -t: Absolute tolerance (default 0)
+  -r: Relative tolerance (default 0)
+  -m: Maximum number of missing/extra events and mismatched values to list (default 10)
+  -v: List all common branches, not only the ones that differ
+  -j: Number of threads (default number of processors)
+*/
+
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdint.h>
+#include "columnar_file.hpp"
+#include "reduced_tree_columns.hpp"
+
+namespace{
+  const uint64_t chunk_size(1 << 16);
+
+  struct EventKey{
+    uint32_t run, lumiblock, event;
+    uint64_t entry;
+
+    bool operator<(const EventKey& other) const{
+      if(run!=other.run) return run<other.run;
+      if(lumiblock!=other.lumiblock) return lumiblock<other.lumiblock;
+      if(event!=other.event) return event<other.event;
+      return entry<other.entry;
+    }
+
+    bool SameEvent(const EventKey& other) const{
+      return run==other.run && lumiblock==other.lumiblock && event==other.event;
+    }
+  };
+
+  struct Matching{
+    std::vector<uint64_t> entries_a, entries_b;
+    std::vector<EventKey> missing, extra;
+    uint64_t duplicates_a, duplicates_b;
+  };
+
+  struct BranchStats{
+    uint64_t mismatches, compared, first_mismatch;
+    double max_abs_diff, max_rel_diff, sum_a, sum_b;
+    double first_a, first_b;
+  };
+
+  struct Comparison{
+    std::vector<std::string> names;
+    std::vector<const ColumnarColumn*> columns_a, columns_b;
+    const Matching* matching;
+    double abs_tolerance, rel_tolerance;
+  };
+
+  struct WorkQueue{
+    const Comparison* comparison;
+    std::vector<std::vector<BranchStats> >* results;
+    std::size_t next_chunk;
+    pthread_mutex_t mutex;
+  };
+
+  const char* GetTypeName(const ColumnType type){
+    switch(type){
+    case kColumnBool: return "bool";
+    case kColumnChar: return "char";
+    case kColumnUInt8: return "uint8";
+    case kColumnInt16: return "int16";
+    case kColumnUInt16: return "uint16";
+    case kColumnInt32: return "int32";
+    case kColumnUInt32: return "uint32";
+    case kColumnFloat: return "float";
+    case kColumnDouble: return "double";
+    default: return "unknown";
+    }
+  }
+
+  std::string FormatEvent(const EventKey& key){
+    std::ostringstream oss("");
+    oss << key.run << ':' << key.lumiblock << ':' << key.event;
+    return oss.str();
+  }
+
+  bool GetKeys(const ReducedTreeColumns& columns, const std::string& file_name,
+               std::vector<EventKey>& keys){
+    const ColumnSpan<uint32_t> run(columns.Get<uint32_t>("run"));
+    const ColumnSpan<uint32_t> lumiblock(columns.Get<uint32_t>("lumiblock"));
+    const ColumnSpan<uint32_t> event(columns.Get<uint32_t>("event"));
+    const uint64_t num_entries(columns.GetNumEntries());
+    keys.resize(num_entries);
+    if(!run.IsValid() || !lumiblock.IsValid() || !event.IsValid()){
+      std::cerr << "Warning: " << file_name << " has no run, lumiblock and event branches. "
+                << "Matching events by entry number." << std::endl;
+      for(uint64_t entry(0); entry<num_entries; ++entry){
+        keys.at(entry).run=0;
+        keys.at(entry).lumiblock=0;
+        keys.at(entry).event=entry;
+        keys.at(entry).entry=entry;
+      }
+      return false;
+    }
+    for(uint64_t entry(0); entry<num_entries; ++entry){
+      keys.at(entry).run=run[entry];
+      keys.at(entry).lumiblock=lumiblock[entry];
+      keys.at(entry).event=event[entry];
+      keys.at(entry).entry=entry;
+    }
+    std::sort(keys.begin(), keys.end());
+    return true;
+  }
+
+  uint64_t RemoveDuplicates(std::vector<EventKey>& keys){
+    //Keeps the first entry of each event
+    if(keys.size()==0) return 0;
+    std::size_t out(1);
+    for(std::size_t in(1); in<keys.size(); ++in){
+      if(!keys.at(in).SameEvent(keys.at(out-1))) keys.at(out++)=keys.at(in);
+    }
+    const uint64_t num_duplicates(keys.size()-out);
+    keys.resize(out);
+    return num_duplicates;
+  }
+
+  void MatchEvents(std::vector<EventKey>& keys_a, std::vector<EventKey>& keys_b, Matching& matching){
+    matching.duplicates_a=RemoveDuplicates(keys_a);
+    matching.duplicates_b=RemoveDuplicates(keys_b);
+    const std::size_t num_matched(std::min(keys_a.size(), keys_b.size()));
+    matching.entries_a.reserve(num_matched);
+    matching.entries_b.reserve(num_matched);
+    std::size_t a(0), b(0);
+    while(a<keys_a.size() && b<keys_b.size()){
+      if(keys_a.at(a).SameEvent(keys_b.at(b))){
+        matching.entries_a.push_back(keys_a.at(a++).entry);
+        matching.entries_b.push_back(keys_b.at(b++).entry);
+      }else if(keys_a.at(a)<keys_b.at(b)){
+        matching.missing.push_back(keys_a.at(a++));
+      }else{
+        matching.extra.push_back(keys_b.at(b++));
+      }
+    }
+    matching.missing.insert(matching.missing.end(), keys_a.begin()+a, keys_a.end());
+    matching.extra.insert(matching.extra.end(), keys_b.begin()+b, keys_b.end());
+  }
+
+  template<typename T>
+  void Gather(const void* values, const uint64_t* entries, const std::size_t n, double* out){
+    const T* data(static_cast<const T*>(values));
+    for(std::size_t i(0); i<n; ++i){
+      out[i]=static_cast<double>(data[entries[i]]);
+    }
+  }
+
+  void Gather(const ColumnarColumn& column, const uint64_t* entries, const std::size_t n, double* out){
+    switch(column.type){
+    case kColumnBool:
+    case kColumnUInt8: Gather<uint8_t>(column.values, entries, n, out); break;
+    case kColumnChar: Gather<char>(column.values, entries, n, out); break;
+    case kColumnInt16: Gather<int16_t>(column.values, entries, n, out); break;
+    case kColumnUInt16: Gather<uint16_t>(column.values, entries, n, out); break;
+    case kColumnInt32: Gather<int32_t>(column.values, entries, n, out); break;
+    case kColumnUInt32: Gather<uint32_t>(column.values, entries, n, out); break;
+    case kColumnFloat: Gather<float>(column.values, entries, n, out); break;
+    case kColumnDouble: Gather<double>(column.values, entries, n, out); break;
+    default: std::fill(out, out+n, 0.0); break;
+    }
+  }
+
+  void ResetStats(BranchStats& stats){
+    stats.mismatches=0;
+    stats.compared=0;
+    stats.first_mismatch=std::numeric_limits<uint64_t>::max();
+    stats.max_abs_diff=0.0;
+    stats.max_rel_diff=0.0;
+    stats.sum_a=0.0;
+    stats.sum_b=0.0;
+    stats.first_a=0.0;
+    stats.first_b=0.0;
+  }
+
+  void CompareChunk(const Comparison& comparison, const std::size_t chunk,
+                    std::vector<BranchStats>& results){
+    const Matching& matching(*comparison.matching);
+    const uint64_t first(chunk*chunk_size);
+    const std::size_t n(std::min(chunk_size, matching.entries_a.size()-first));
+    std::vector<double> values_a(n), values_b(n);
+    results.resize(comparison.names.size());
+    for(std::size_t branch(0); branch<comparison.names.size(); ++branch){
+      BranchStats& stats(results.at(branch));
+      ResetStats(stats);
+      Gather(*comparison.columns_a.at(branch), &matching.entries_a.at(first), n, &values_a.at(0));
+      Gather(*comparison.columns_b.at(branch), &matching.entries_b.at(first), n, &values_b.at(0));
+      for(std::size_t i(0); i<n; ++i){
+        const double a(values_a[i]), b(values_b[i]);
+        const bool a_nan(a!=a), b_nan(b!=b);
+        double abs_diff(0.0), rel_diff(0.0);
+        if(a_nan || b_nan){
+          if(a_nan && b_nan) continue;
+          abs_diff=std::numeric_limits<double>::infinity();
+          rel_diff=std::numeric_limits<double>::infinity();
+        }else{
+          stats.sum_a+=a;
+          stats.sum_b+=b;
+          ++stats.compared;
+          if(a==b) continue;
+          abs_diff=fabs(a-b);
+          const double scale(std::max(fabs(a), fabs(b)));
+          rel_diff=scale>0.0?abs_diff/scale:0.0;
+        }
+        if(abs_diff>stats.max_abs_diff) stats.max_abs_diff=abs_diff;
+        if(rel_diff>stats.max_rel_diff) stats.max_rel_diff=rel_diff;
+        if(abs_diff>comparison.abs_tolerance
+           && abs_diff>comparison.rel_tolerance*std::max(fabs(a), fabs(b))){
+          if(stats.mismatches==0){
+            stats.first_mismatch=first+i;
+            stats.first_a=a;
+            stats.first_b=b;
+          }
+          ++stats.mismatches;
+        }
+      }
+    }
+  }
+
+  void* RunWorker(void* arg){
+    WorkQueue& queue(*static_cast<WorkQueue*>(arg));
+    for(;;){
+      pthread_mutex_lock(&queue.mutex);
+      const std::size_t chunk(queue.next_chunk++);
+      pthread_mutex_unlock(&queue.mutex);
+      if(chunk>=queue.results->size()) break;
+      CompareChunk(*queue.comparison, chunk, queue.results->at(chunk));
+    }
+    return NULL;
+  }
+
+  void MergeStats(const std::vector<std::vector<BranchStats> >& results, std::vector<BranchStats>& totals){
+    //Chunks are merged in order so that the first mismatch does not depend on the threads
+    for(std::size_t branch(0); branch<totals.size(); ++branch){
+      ResetStats(totals.at(branch));
+    }
+    for(std::size_t chunk(0); chunk<results.size(); ++chunk){
+      for(std::size_t branch(0); branch<totals.size(); ++branch){
+        const BranchStats& stats(results.at(chunk).at(branch));
+        BranchStats& total(totals.at(branch));
+        if(total.mismatches==0 && stats.mismatches>0){
+          total.first_mismatch=stats.first_mismatch;
+          total.first_a=stats.first_a;
+          total.first_b=stats.first_b;
+        }
+        total.mismatches+=stats.mismatches;
+        total.compared+=stats.compared;
+        total.max_abs_diff=std::max(total.max_abs_diff, stats.max_abs_diff);
+        total.max_rel_diff=std::max(total.max_rel_diff, stats.max_rel_diff);
+        total.sum_a+=stats.sum_a;
+        total.sum_b+=stats.sum_b;
+      }
+    }
+  }
+
+  void PrintEvents(const std::string& title, const std::vector<EventKey>& keys, const unsigned max_listed){
+    std::cout << title << ": " << keys.size() << std::endl;
+    for(std::size_t i(0); i<keys.size() && i<max_listed; ++i){
+      std::cout << "  " << FormatEvent(keys.at(i)) << " (entry " << keys.at(i).entry << ')' << std::endl;
+    }
+    if(keys.size()>max_listed) std::cout << "  ..." << std::endl;
+  }
+
+  bool UpdateColumns(const std::string& file_name){
+    if(!ReducedTreeColumnsAreOutOfDate(file_name)) return true;
+    const std::string columns_name(GetReducedTreeColumnsName(file_name));
+    std::cout << "Exporting " << file_name << " to " << columns_name << std::endl;
+    return ExportReducedTree(file_name, columns_name);
+  }
+}
+
+int main(int argc, char *argv[]){
+  std::string file_name_a(""), file_name_b("");
+  double abs_tolerance(0.0), rel_tolerance(0.0);
+  unsigned max_listed(10);
+  bool verbose(false);
+  long num_threads(sysconf(_SC_NPROCESSORS_ONLN));
+
+  int c(0);
+  while((c=getopt(argc, argv, "a:b:t:r:m:vj:"))!=-1){
+    switch(c){
+    case 'a':
+      file_name_a=optarg;
+      break;
+    case 'b':
+      file_name_b=optarg;
+      break;
+    case 't':
+      abs_tolerance=atof(optarg);
+      break;
+    case 'r':
+      rel_tolerance=atof(optarg);
+      break;
+    case 'm':
+      max_listed=atoi(optarg);
+      break;
+    case 'v':
+      verbose=true;
+      break;
+    case 'j':
+      num_threads=atoi(optarg);
+      break;
+    default:
+      break;
+    }
+  }
+  if(num_threads<1) num_threads=1;
+  if(file_name_a=="" || file_name_b==""){
+    std::cerr << "Error: Both a reference (-a) and a candidate (-b) file are needed." << std::endl;
+    return 1;
+  }
+
+  if(!UpdateColumns(file_name_a) || !UpdateColumns(file_name_b)) return 1;
+  const ReducedTreeColumns columns_a(GetReducedTreeColumnsName(file_name_a));
+  const ReducedTreeColumns columns_b(GetReducedTreeColumnsName(file_name_b));
+  if(!columns_a.IsOpen() || !columns_b.IsOpen()) return 1;
+
+  std::cout << "Reference: " << file_name_a << " (" << columns_a.GetNumEntries() << " events)" << std::endl;
+  std::cout << "Candidate: " << file_name_b << " (" << columns_b.GetNumEntries() << " events)" << std::endl;
+
+  std::vector<EventKey> keys_a(0), keys_b(0);
+  const bool keyed_a(GetKeys(columns_a, file_name_a, keys_a));
+  const bool keyed_b(GetKeys(columns_b, file_name_b, keys_b));
+  if(keyed_a!=keyed_b){
+    std::cerr << "Error: Only one of the files has run, lumiblock and event branches." << std::endl;
+    return 1;
+  }
+  Matching matching;
+  MatchEvents(keys_a, keys_b, matching);
+  std::vector<EventKey>().swap(keys_a);
+  std::vector<EventKey>().swap(keys_b);
+
+  std::cout << "Matched events: " << matching.entries_a.size() << std::endl;
+  PrintEvents("Missing events (only in reference)", matching.missing, max_listed);
+  PrintEvents("Extra events (only in candidate)", matching.extra, max_listed);
+  std::cout << "Duplicate events: " << matching.duplicates_a << " in reference, "
+            << matching.duplicates_b << " in candidate" << std::endl;
+
+  Comparison comparison;
+  comparison.matching=&matching;
+  comparison.abs_tolerance=abs_tolerance;
+  comparison.rel_tolerance=rel_tolerance;
+  std::vector<std::string> only_a(0), only_b(0), skipped(0);
+  const std::vector<ColumnarColumn>& all_a(columns_a.GetFile().GetColumns());
+  for(std::size_t i(0); i<all_a.size(); ++i){
+    const ColumnarColumn* column_b(columns_b.GetFile().GetColumn(all_a.at(i).name));
+    if(column_b==NULL){
+      only_a.push_back(all_a.at(i).name);
+    }else if(all_a.at(i).depth!=0 || column_b->depth!=0){
+      skipped.push_back(all_a.at(i).name);
+    }else{
+      if(all_a.at(i).type!=column_b->type){
+        std::cout << "Branch " << all_a.at(i).name << " changed type from "
+                  << GetTypeName(all_a.at(i).type) << " to " << GetTypeName(column_b->type) << std::endl;
+      }
+      comparison.names.push_back(all_a.at(i).name);
+      comparison.columns_a.push_back(&all_a.at(i));
+      comparison.columns_b.push_back(column_b);
+    }
+  }
+  const std::vector<ColumnarColumn>& all_b(columns_b.GetFile().GetColumns());
+  for(std::size_t i(0); i<all_b.size(); ++i){
+    if(columns_a.GetFile().GetColumn(all_b.at(i).name)==NULL) only_b.push_back(all_b.at(i).name);
+  }
+  std::cout << "Branches only in reference:";
+  for(std::size_t i(0); i<only_a.size(); ++i) std::cout << ' ' << only_a.at(i);
+  std::cout << std::endl << "Branches only in candidate:";
+  for(std::size_t i(0); i<only_b.size(); ++i) std::cout << ' ' << only_b.at(i);
+  std::cout << std::endl;
+  for(std::size_t i(0); i<skipped.size(); ++i){
+    std::cerr << "Warning: skipping nested branch " << skipped.at(i) << '.' << std::endl;
+  }
+
+  const std::size_t num_chunks((matching.entries_a.size()+chunk_size-1)/chunk_size);
+  std::vector<std::vector<BranchStats> > results(num_chunks);
+  WorkQueue queue;
+  queue.comparison=&comparison;
+  queue.results=&results;
+  queue.next_chunk=0;
+  pthread_mutex_init(&queue.mutex, NULL);
+  std::vector<pthread_t> threads(std::min(static_cast<std::size_t>(num_threads), std::max(num_chunks, static_cast<std::size_t>(1))));
+  for(std::size_t thread(0); thread<threads.size(); ++thread){
+    pthread_create(&threads.at(thread), NULL, RunWorker, &queue);
+  }
+  for(std::size_t thread(0); thread<threads.size(); ++thread){
+    pthread_join(threads.at(thread), NULL);
+  }
+  pthread_mutex_destroy(&queue.mutex);
+
+  std::vector<BranchStats> totals(comparison.names.size());
+  MergeStats(results, totals);
+
+  std::size_t num_different(0);
+  std::cout << std::endl << std::setw(32) << std::left << "Branch" << std::right
+            << std::setw(12) << "Mismatches" << std::setw(12) << "Fraction"
+            << std::setw(14) << "Max abs diff" << std::setw(14) << "Max rel diff"
+            << std::setw(14) << "Mean (ref)" << std::setw(14) << "Mean (cand)" << std::endl;
+  for(std::size_t branch(0); branch<totals.size(); ++branch){
+    const BranchStats& stats(totals.at(branch));
+    if(stats.mismatches>0) ++num_different;
+    if(stats.mismatches==0 && !verbose) continue;
+    std::cout << std::setw(32) << std::left << comparison.names.at(branch) << std::right
+              << std::setw(12) << stats.mismatches
+              << std::setw(12) << (matching.entries_a.size()?static_cast<double>(stats.mismatches)/matching.entries_a.size():0.0)
+              << std::setw(14) << stats.max_abs_diff << std::setw(14) << stats.max_rel_diff
+              << std::setw(14) << (stats.compared?stats.sum_a/stats.compared:0.0)
+              << std::setw(14) << (stats.compared?stats.sum_b/stats.compared:0.0) << std::endl;
+  }
+  for(std::size_t branch(0); branch<totals.size() && max_listed>0; ++branch){
+    const BranchStats& stats(totals.at(branch));
+    if(stats.mismatches==0) continue;
+    const uint64_t entry_a(matching.entries_a.at(stats.first_mismatch));
+    EventKey key;
+    key.run=keyed_a?columns_a.Get<uint32_t>("run")[entry_a]:0;
+    key.lumiblock=keyed_a?columns_a.Get<uint32_t>("lumiblock")[entry_a]:0;
+    key.event=keyed_a?columns_a.Get<uint32_t>("event")[entry_a]:entry_a;
+    std::cout << "First mismatch in " << comparison.names.at(branch) << ": event " << FormatEvent(key)
+              << std::setprecision(10) << ", reference " << stats.first_a
+              << ", candidate " << stats.first_b << std::setprecision(6) << std::endl;
+  }
+
+  const bool same(num_different==0 && only_a.size()==0 && only_b.size()==0
+                  && matching.missing.size()==0 && matching.extra.size()==0);
+  std::cout << std::endl << comparison.names.size() << " branches compared, " << num_different
+            << " differ. " << (same?"Files agree.":"Files differ.") << std::endl;
+  return same?0:2;
+}
@@ -0,0 +1,156 @@
+/*
+  Counts the heap allocations made while reading entries the way the event loop does, to check that it stops allocating once the branch containers have grown to their working size. Every entry is read with EventHandler::GetEntry and its trigger decisions are updated through EventHandler::GetTriggerMask, so trigger_name is reloaded exactly when any trigger selection would reload it. All calls to malloc, calloc and realloc in the process are counted, which covers operator new as well as ROOT's own buffers; glibc is required.
+  Input: cfA ntuple, list of cfA ntuples or .cfacache file given with -i
+  Output: number of allocations during the warm-up and during the measured entries, and the entries that still allocated
+  Options:
+  -i: Input file
+  -l: Input file is a list of files
+  -w: Number of warm-up entries (default 1000)
+  -n: Number of measured entries after the warm-up (default 10000)
+  -m: Maximum number of allocating entries to list (default 10)
+  -t: For comparison, read trigger_name with every entry instead of only when the trigger menu can change (ntuples only)
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "event_handler.hpp"
+
+namespace{
+  volatile unsigned long num_allocations(0);
+
+  class AllocationProbe : public EventHandler{
+  public:
+    AllocationProbe(const std::string& file_name, const bool is_list, const bool all_triggers):
+      EventHandler(file_name, is_list, 1.0, false){
+      if(all_triggers && cfACache==NULL) chainB.SetBranchStatus("trigger_name",1);
+    }
+
+    void ReadEntry(const unsigned entry){
+      GetEntry(entry);
+      GetTriggerMask();
+    }
+
+    int GetNumEntries() const{
+      return GetTotalEntries();
+    }
+  };
+}
+
+//The allocator entry points are replaced only in this executable, so the rest
+//of the code has no counting overhead. Shared libraries, ROOT and libstdc++'s
+//operator new included, resolve malloc to these definitions, which hand the
+//request on to glibc. They must repeat the exception specification glibc gives
+//its declarations.
+#if __cplusplus < 201103L
+#define NO_THROW throw()
+#else
+#define NO_THROW noexcept
+#endif
+
+extern "C"{
+  void* __libc_malloc(std::size_t size);
+  void* __libc_calloc(std::size_t num, std::size_t size);
+  void* __libc_realloc(void* memory, std::size_t size);
+
+  void* malloc(std::size_t size) NO_THROW{
+    __sync_fetch_and_add(&num_allocations, 1UL);
+    return __libc_malloc(size);
+  }
+
+  void* calloc(std::size_t num, std::size_t size) NO_THROW{
+    __sync_fetch_and_add(&num_allocations, 1UL);
+    return __libc_calloc(num, size);
+  }
+
+  void* realloc(void* memory, std::size_t size) NO_THROW{
+    __sync_fetch_and_add(&num_allocations, 1UL);
+    return __libc_realloc(memory, size);
+  }
+}
+
+int main(int argc, char *argv[]){
+  std::string in_file_name("");
+  bool is_list(false), all_triggers(false);
+  unsigned num_warm_up(1000), num_measured(10000), max_listed(10);
+
+  int c(0);
+  while((c=getopt(argc, argv, "i:lw:n:m:t"))!=-1){
+    switch(c){
+    case 'i':
+      in_file_name=optarg;
+      break;
+    case 'l':
+      is_list=true;
+      break;
+    case 'w':
+      num_warm_up=atoi(optarg);
+      break;
+    case 'n':
+      num_measured=atoi(optarg);
+      break;
+    case 'm':
+      max_listed=atoi(optarg);
+      break;
+    case 't':
+      all_triggers=true;
+      break;
+    default:
+      break;
+    }
+  }
+  if(in_file_name==""){
+    std::cerr << "Error: No input file given (-i)." << std::endl;
+    return 1;
+  }
+
+  AllocationProbe probe(in_file_name, is_list, all_triggers);
+  const unsigned num_entries(probe.GetNumEntries()>0?probe.GetNumEntries():0);
+  if(num_entries==0){
+    std::cerr << "Error: No entries in " << in_file_name << '.' << std::endl;
+    return 1;
+  }
+  if(num_warm_up>=num_entries) num_warm_up=num_entries/10;
+  if(num_warm_up+num_measured>num_entries) num_measured=num_entries-num_warm_up;
+
+  std::vector<unsigned> allocating_entries(0);
+  std::vector<unsigned long> allocations_per_entry(0);
+  allocating_entries.reserve(max_listed);
+  allocations_per_entry.reserve(max_listed);
+
+  const unsigned long start(num_allocations);
+  for(unsigned entry(0); entry<num_warm_up; ++entry){
+    probe.ReadEntry(entry);
+  }
+  const unsigned long warm_up_allocations(num_allocations-start);
+
+  unsigned num_allocating_entries(0);
+  const unsigned long measured_start(num_allocations);
+  for(unsigned entry(num_warm_up); entry<num_warm_up+num_measured; ++entry){
+    const unsigned long before(num_allocations);
+    probe.ReadEntry(entry);
+    const unsigned long allocations(num_allocations-before);
+    if(allocations==0) continue;
+    ++num_allocating_entries;
+    if(allocating_entries.size()<max_listed){
+      allocating_entries.push_back(entry);
+      allocations_per_entry.push_back(allocations);
+    }
+  }
+  const unsigned long measured_allocations(num_allocations-measured_start);
+
+  std::cout << "Warm-up: " << warm_up_allocations << " allocations in "
+            << num_warm_up << " entries" << std::endl;
+  std::cout << "Measured: " << measured_allocations << " allocations in "
+            << num_measured << " entries ("
+            << (num_measured?static_cast<double>(measured_allocations)/num_measured:0.0)
+            << " per entry), " << num_allocating_entries << " entries allocated" << std::endl;
+  for(std::size_t i(0); i<allocating_entries.size(); ++i){
+    std::cout << "  entry " << allocating_entries.at(i) << ": "
+              << allocations_per_entry.at(i) << " allocations" << std::endl;
+  }
+  if(measured_allocations==0) std::cout << "No allocations in the steady state." << std::endl;
+  return 0;
+}
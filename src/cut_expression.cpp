@@ -0,0 +1,346 @@
+#include "cut_expression.hpp"
+#include <cmath>
+#include <cctype>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <stdint.h>
+#include "columnar_file.hpp"
+
+namespace{
+  template<typename T>
+  void LoadColumn(const void* values, const uint64_t first, const std::size_t num, double* out){
+    const T* in(static_cast<const T*>(values)+first);
+    for(std::size_t i(0); i<num; ++i){
+      out[i]=in[i];
+    }
+  }
+
+  bool IsIdentifierStart(const char c){
+    return isalpha(static_cast<unsigned char>(c)) || c=='_';
+  }
+
+  bool IsIdentifierChar(const char c){
+    return isalnum(static_cast<unsigned char>(c)) || c=='_';
+  }
+}
+
+CutExpression::CutExpression(const std::string& expression):
+  expression_(expression),
+  error_(""),
+  branches_(0),
+  instructions_(0),
+  inputs_(0),
+  registers_(0),
+  num_registers_(0),
+  result_(0),
+  bound_(false),
+  pos_(0){
+  Compile();
+}
+
+bool CutExpression::IsValid() const{
+  return error_=="";
+}
+
+const std::string& CutExpression::GetError() const{
+  return error_;
+}
+
+const std::string& CutExpression::GetExpression() const{
+  return expression_;
+}
+
+const std::vector<std::string>& CutExpression::GetBranches() const{
+  return branches_;
+}
+
+bool CutExpression::Compile(){
+  pos_=0;
+  if(!ParseOr(result_)) return false;
+  SkipSpace();
+  if(pos_<expression_.size()) return Fail("unexpected '"+expression_.substr(pos_)+"'");
+  return true;
+}
+
+bool CutExpression::Fail(const std::string& message){
+  if(error_==""){
+    std::ostringstream oss("");
+    oss << "Error: could not compile \"" << expression_ << "\" at position " << pos_ << ": " << message << '.';
+    error_=oss.str();
+  }
+  return false;
+}
+
+void CutExpression::SkipSpace(){
+  while(pos_<expression_.size() && isspace(static_cast<unsigned char>(expression_.at(pos_)))) ++pos_;
+}
+
+bool CutExpression::Accept(const std::string& token){
+  SkipSpace();
+  if(expression_.compare(pos_, token.size(), token)!=0) return false;
+  //Don't split "<=" into "<" and "=" or "&&" into "&"
+  const std::string::size_type next(pos_+token.size());
+  if(token.size()==1 && next<expression_.size()){
+    const char c(expression_.at(next));
+    if((token=="<" || token==">" || token=="!") && c=='=') return false;
+  }
+  pos_=next;
+  return true;
+}
+
+std::size_t CutExpression::Emit(const OpCode op, const std::size_t a, const std::size_t b, const double constant){
+  Instruction instruction;
+  instruction.op=op;
+  instruction.out=num_registers_++;
+  instruction.a=a;
+  instruction.b=b;
+  instruction.constant=constant;
+  instructions_.push_back(instruction);
+  return instruction.out;
+}
+
+std::size_t CutExpression::GetBranchIndex(const std::string& name){
+  for(std::size_t i(0); i<branches_.size(); ++i){
+    if(branches_.at(i)==name) return i;
+  }
+  branches_.push_back(name);
+  return branches_.size()-1;
+}
+
+bool CutExpression::ParseOr(std::size_t& reg){
+  if(!ParseAnd(reg)) return false;
+  while(Accept("||")){
+    std::size_t rhs(0);
+    if(!ParseAnd(rhs)) return false;
+    reg=Emit(kOr, reg, rhs);
+  }
+  return true;
+}
+
+bool CutExpression::ParseAnd(std::size_t& reg){
+  if(!ParseEquality(reg)) return false;
+  while(Accept("&&")){
+    std::size_t rhs(0);
+    if(!ParseEquality(rhs)) return false;
+    reg=Emit(kAnd, reg, rhs);
+  }
+  return true;
+}
+
+bool CutExpression::ParseEquality(std::size_t& reg){
+  if(!ParseRelational(reg)) return false;
+  for(;;){
+    OpCode op(kEqual);
+    if(Accept("==")){
+      op=kEqual;
+    }else if(Accept("!=")){
+      op=kNotEqual;
+    }else{
+      return true;
+    }
+    std::size_t rhs(0);
+    if(!ParseRelational(rhs)) return false;
+    reg=Emit(op, reg, rhs);
+  }
+}
+
+bool CutExpression::ParseRelational(std::size_t& reg){
+  if(!ParseAdditive(reg)) return false;
+  for(;;){
+    OpCode op(kLess);
+    if(Accept("<=")){
+      op=kLessEqual;
+    }else if(Accept(">=")){
+      op=kGreaterEqual;
+    }else if(Accept("<")){
+      op=kLess;
+    }else if(Accept(">")){
+      op=kGreater;
+    }else{
+      return true;
+    }
+    std::size_t rhs(0);
+    if(!ParseAdditive(rhs)) return false;
+    reg=Emit(op, reg, rhs);
+  }
+}
+
+bool CutExpression::ParseAdditive(std::size_t& reg){
+  if(!ParseMultiplicative(reg)) return false;
+  for(;;){
+    OpCode op(kAdd);
+    if(Accept("+")){
+      op=kAdd;
+    }else if(Accept("-")){
+      op=kSubtract;
+    }else{
+      return true;
+    }
+    std::size_t rhs(0);
+    if(!ParseMultiplicative(rhs)) return false;
+    reg=Emit(op, reg, rhs);
+  }
+}
+
+bool CutExpression::ParseMultiplicative(std::size_t& reg){
+  if(!ParseUnary(reg)) return false;
+  for(;;){
+    OpCode op(kMultiply);
+    if(Accept("*")){
+      op=kMultiply;
+    }else if(Accept("/")){
+      op=kDivide;
+    }else{
+      return true;
+    }
+    std::size_t rhs(0);
+    if(!ParseUnary(rhs)) return false;
+    reg=Emit(op, reg, rhs);
+  }
+}
+
+bool CutExpression::ParseUnary(std::size_t& reg){
+  if(Accept("!")){
+    if(!ParseUnary(reg)) return false;
+    reg=Emit(kNot, reg);
+    return true;
+  }else if(Accept("-")){
+    if(!ParseUnary(reg)) return false;
+    reg=Emit(kNegate, reg);
+    return true;
+  }else if(Accept("+")){
+    return ParseUnary(reg);
+  }else{
+    return ParsePrimary(reg);
+  }
+}
+
+bool CutExpression::ParsePrimary(std::size_t& reg){
+  SkipSpace();
+  if(pos_>=expression_.size()) return Fail("unexpected end of expression");
+  const char c(expression_.at(pos_));
+  if(Accept("(")){
+    if(!ParseOr(reg)) return false;
+    if(!Accept(")")) return Fail("expected ')'");
+    return true;
+  }else if(isdigit(static_cast<unsigned char>(c)) || c=='.'){
+    const char* begin(expression_.c_str()+pos_);
+    char* end(NULL);
+    const double value(strtod(begin, &end));
+    if(end==begin) return Fail("bad number");
+    pos_+=end-begin;
+    reg=Emit(kConstant, 0, 0, value);
+    return true;
+  }else if(IsIdentifierStart(c)){
+    const std::string::size_type begin(pos_);
+    while(pos_<expression_.size()
+          && (IsIdentifierChar(expression_.at(pos_))
+              || expression_.compare(pos_, 2, "::")==0)){
+      pos_+=expression_.compare(pos_, 2, "::")==0?2:1;
+    }
+    const std::string name(expression_.substr(begin, pos_-begin));
+    if(name=="true" || name=="false"){
+      reg=Emit(kConstant, 0, 0, name=="true"?1.0:0.0);
+      return true;
+    }
+    if(Accept("(")){
+      OpCode op(kAbs);
+      if(name=="abs" || name=="fabs" || name=="TMath::Abs"){
+        op=kAbs;
+      }else if(name=="sqrt" || name=="TMath::Sqrt"){
+        op=kSqrt;
+      }else{
+        return Fail("unknown function "+name);
+      }
+      std::size_t arg(0);
+      if(!ParseOr(arg)) return false;
+      if(!Accept(")")) return Fail("expected ')'");
+      reg=Emit(op, arg);
+      return true;
+    }
+    reg=Emit(kLoad, GetBranchIndex(name));
+    return true;
+  }else{
+    return Fail(std::string("unexpected '")+c+"'");
+  }
+}
+
+bool CutExpression::Bind(const ColumnarFile& file){
+  bound_=false;
+  if(!IsValid()) return false;
+  inputs_.resize(branches_.size());
+  for(std::size_t i(0); i<branches_.size(); ++i){
+    const ColumnarColumn* column(file.GetColumn(branches_.at(i)));
+    if(column==NULL || column->depth!=0){
+      error_="Error: branch "+branches_.at(i)+" needed by \""+expression_+"\" is missing or not a scalar.";
+      return false;
+    }
+    inputs_.at(i).type=column->type;
+    inputs_.at(i).values=column->values;
+  }
+
+  registers_.assign(num_registers_*batch_size, 0.0);
+  for(std::vector<Instruction>::const_iterator it(instructions_.begin());
+      it!=instructions_.end(); ++it){
+    if(it->op==kConstant){
+      double* out(&registers_.at(it->out*batch_size));
+      for(std::size_t i(0); i<batch_size; ++i) out[i]=it->constant;
+    }
+  }
+  bound_=true;
+  return true;
+}
+
+const double* CutExpression::Evaluate(const uint64_t first_entry, const std::size_t num_entries){
+  //Returns values for entries [first_entry, first_entry+num_entries), which must
+  //hold no more than batch_size entries. The pointer is valid until the next call.
+  if(!bound_ || num_entries>batch_size) return NULL;
+  const std::size_t n(num_entries);
+  double* const base(&registers_.at(0));
+  for(std::vector<Instruction>::const_iterator it(instructions_.begin());
+      it!=instructions_.end(); ++it){
+    double* const out(base+it->out*batch_size);
+    const double* const a(base+it->a*batch_size);
+    const double* const b(base+it->b*batch_size);
+    switch(it->op){
+    case kLoad:
+      {
+        const Input& input(inputs_.at(it->a));
+        switch(input.type){
+        case kColumnBool:
+        case kColumnUInt8: LoadColumn<uint8_t>(input.values, first_entry, n, out); break;
+        case kColumnChar: LoadColumn<char>(input.values, first_entry, n, out); break;
+        case kColumnInt16: LoadColumn<int16_t>(input.values, first_entry, n, out); break;
+        case kColumnUInt16: LoadColumn<uint16_t>(input.values, first_entry, n, out); break;
+        case kColumnInt32: LoadColumn<int32_t>(input.values, first_entry, n, out); break;
+        case kColumnUInt32: LoadColumn<uint32_t>(input.values, first_entry, n, out); break;
+        case kColumnFloat: LoadColumn<float>(input.values, first_entry, n, out); break;
+        case kColumnDouble: LoadColumn<double>(input.values, first_entry, n, out); break;
+        default: break;
+        }
+      }
+      break;
+    case kConstant: break;
+    case kNegate: for(std::size_t i(0); i<n; ++i) out[i]=-a[i]; break;
+    case kNot: for(std::size_t i(0); i<n; ++i) out[i]=a[i]==0.0?1.0:0.0; break;
+    case kAbs: for(std::size_t i(0); i<n; ++i) out[i]=fabs(a[i]); break;
+    case kSqrt: for(std::size_t i(0); i<n; ++i) out[i]=sqrt(a[i]); break;
+    case kAdd: for(std::size_t i(0); i<n; ++i) out[i]=a[i]+b[i]; break;
+    case kSubtract: for(std::size_t i(0); i<n; ++i) out[i]=a[i]-b[i]; break;
+    case kMultiply: for(std::size_t i(0); i<n; ++i) out[i]=a[i]*b[i]; break;
+    case kDivide: for(std::size_t i(0); i<n; ++i) out[i]=b[i]==0.0?0.0:a[i]/b[i]; break;
+    case kLess: for(std::size_t i(0); i<n; ++i) out[i]=a[i]<b[i]?1.0:0.0; break;
+    case kLessEqual: for(std::size_t i(0); i<n; ++i) out[i]=a[i]<=b[i]?1.0:0.0; break;
+    case kGreater: for(std::size_t i(0); i<n; ++i) out[i]=a[i]>b[i]?1.0:0.0; break;
+    case kGreaterEqual: for(std::size_t i(0); i<n; ++i) out[i]=a[i]>=b[i]?1.0:0.0; break;
+    case kEqual: for(std::size_t i(0); i<n; ++i) out[i]=a[i]==b[i]?1.0:0.0; break;
+    case kNotEqual: for(std::size_t i(0); i<n; ++i) out[i]=a[i]!=b[i]?1.0:0.0; break;
+    case kAnd: for(std::size_t i(0); i<n; ++i) out[i]=(a[i]!=0.0 && b[i]!=0.0)?1.0:0.0; break;
+    case kOr: for(std::size_t i(0); i<n; ++i) out[i]=(a[i]!=0.0 || b[i]!=0.0)?1.0:0.0; break;
+    default: break;
+    }
+  }
+  return base+result_*batch_size;
+}
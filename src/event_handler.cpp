@@ -10,17 +10,20 @@
 #include <vector>
 #include <string>
 #include <set>
+#include <map>
 #include <utility>
 #include <iostream>
 #include <sstream>
 #include <algorithm>
 #include <functional>
 #include <limits>
+#include <pthread.h>
 #include "TChain.h"
 #include "TTree.h"
 #include "TBranch.h"
 #include "TFile.h"
 #include "TObjArray.h"
+#include "TChainElement.h"
 #include "TH1D.h"
 #include "TH2D.h"
 #include "TCanvas.h"
@@ -29,20 +32,105 @@
 #include "cfa.hpp"
 #include "math.hpp"
 #include "in_json_2012.hpp"
+#include "cfa_cache.hpp"
+#include "columnar_file.hpp"
+#include "weighted_histogram.hpp"
 #include "mt2_bisect.hpp"
+#include "file_stager.hpp"
+
+namespace{
+  //One block of a cfA cache, filled into its own slot of the shared histogram
+  struct PileupProfileJob{
+    const ColumnarColumn* bunch_crossings;
+    const ColumnarColumn* true_interactions;
+    uint64_t first_entry, end_entry;
+    WeightedHistogram* histo;
+    std::size_t slot;
+  };
+
+  void* FillPileupProfile(void* arg){
+    const PileupProfileJob& job(*static_cast<PileupProfileJob*>(arg));
+    const int* const bunch_crossings(static_cast<const int*>(job.bunch_crossings->values));
+    const float* const true_interactions(static_cast<const float*>(job.true_interactions->values));
+    const uint64_t* const bx_offsets(job.bunch_crossings->offsets[0]);
+    const uint64_t* const ti_offsets(job.true_interactions->offsets[0]);
+    for(uint64_t entry(job.first_entry); entry<job.end_entry; ++entry){
+      //Same choice as GetNumInteractions: the last in-time crossing, or -1 if there is none
+      double num_interactions(-1.0);
+      const uint64_t size(std::min(bx_offsets[entry+1]-bx_offsets[entry], ti_offsets[entry+1]-ti_offsets[entry]));
+      for(uint64_t i(0); i<size; ++i){
+        if(bunch_crossings[bx_offsets[entry]+i]==0) num_interactions=true_interactions[ti_offsets[entry]+i];
+      }
+      job.histo->Fill(job.slot, num_interactions, 1.0);
+    }
+    return NULL;
+  }
+
+  //The SMS masses are the second and third fields of model_params, e.g. "T1tttt_1500_500 ..."
+  int ParseMass1(const std::string& model_params){
+    const std::string::size_type p1(model_params.find('_'));
+    const std::string::size_type p2(model_params.find('_',p1+1));
+    if(p1!=std::string::npos && p2!=std::string::npos){
+      return atoi(model_params.substr(p1+1,p2-p1-1).c_str());
+    }else{
+      return -1;
+    }
+  }
+
+  int ParseMass2(const std::string& model_params){
+    const std::string::size_type p1(model_params.find('_'));
+    const std::string::size_type p2(model_params.find('_',p1+1));
+    const std::string::size_type p3(model_params.find(' ',p2+1));
+    if(p2!=std::string::npos && p3!=std::string::npos){
+      return atoi(model_params.substr(p2+1,p3-p2-1).c_str());
+    }else{
+      return -1;
+    }
+  }
+
+  //One block of the model_params column of a cfA cache, counted into its own map
+  struct MassPointJob{
+    const ColumnarColumn* model_params;
+    uint64_t first_entry, end_entry;
+    std::map<std::pair<int, int>, int> counts;
+  };
+
+  void* CountMassPoints(void* arg){
+    MassPointJob& job(*static_cast<MassPointJob*>(arg));
+    const char* const chars(static_cast<const char*>(job.model_params->values));
+    const uint64_t* const offsets(job.model_params->offsets[0]);
+    std::string model_params("");
+    for(uint64_t entry(job.first_entry); entry<job.end_entry; ++entry){
+      model_params.assign(chars+offsets[entry], chars+offsets[entry+1]);
+      ++job.counts[std::make_pair(ParseMass1(model_params), ParseMass2(model_params))];
+    }
+    return NULL;
+  }
+}
 
 const double EventHandler::CSVTCut(0.898);
 const double EventHandler::CSVMCut(0.679);
 const double EventHandler::CSVLCut(0.244);
-const std::vector<std::vector<int> > VRunLumiPrompt(MakeVRunLumi("Golden"));
-const std::vector<std::vector<int> > VRunLumi24Aug(MakeVRunLumi("24Aug"));
-const std::vector<std::vector<int> > VRunLumi13Jul(MakeVRunLumi("13Jul"));
+const LumiMask VRunLumiPrompt(MakeVRunLumi("Golden"));
+const LumiMask VRunLumi24Aug(MakeVRunLumi("24Aug"));
+const LumiMask VRunLumi13Jul(MakeVRunLumi("13Jul"));
 
 EventHandler::EventHandler(const std::string &fileName, const bool isList, const double scaleFactorIn, const bool fastMode):
   cfA(fileName, isList),
   scaleFactor(scaleFactorIn),
+  input_name_(fileName),
+  sample_traits_(sampleName),
   beta_(0),
-  beta_cached_(false){
+  beta_cached_(false),
+  mc_truth_(),
+  mc_truth_cached_(false),
+  trigger_index_(),
+  trigger_decisions_cached_(false),
+  trigger_tree_(-1),
+  trigger_run_(0),
+  stager_(NULL),
+  staged_files_(0),
+  staged_file_(-1){
   if (fastMode) { // turn off unnecessary branches
     chainA.SetBranchStatus("els_*",0);
     chainA.SetBranchStatus("triggerobject_*",0);
@@ -73,18 +161,42 @@ EventHandler::EventHandler(const std::string &fileName, const bool isList, const
     chainB.SetBranchStatus("Nmc_doc*",1);
     chainB.SetBranchStatus("mc_doc*",1);
   }
-  }
+  //The trigger menu is only read when it can change (see UpdateTriggerDecisions):
+  //ROOT streams each std::string through a temporary TString, so reading the
+  //names with every entry allocates once per trigger no matter how the
+  //vector's storage is kept
+  if(cfACache==NULL) chainB.SetBranchStatus("trigger_name",0);
+}
+
+EventHandler::EventHandler(const std::string& sample_name):
+  cfA(sample_name),
+  scaleFactor(1.0),
+  input_name_(""),
+  sample_traits_(sampleName),
+  beta_(0),
+  beta_cached_(false),
+  mc_truth_(),
+  mc_truth_cached_(false),
+  trigger_index_(),
+  trigger_decisions_cached_(false),
+  trigger_tree_(-1),
+  trigger_run_(0),
+  stager_(NULL),
+  staged_files_(0),
+  staged_file_(-1){
+}
 
 void EventHandler::SetScaleFactor(const double crossSection, const double luminosity, int numEntries){
-  const int maxEntriesA(chainA.GetEntries()), maxEntriesB(chainB.GetEntries());
-  if(maxEntriesA!=maxEntriesB){
+  //Counted when the input was opened, which also covers a cfA cache with empty chains
+  const int maxEntries(GetTotalEntries());
+  if(maxEntries<0){
     fprintf(stderr,"Error: Chains have different numbers of entries.\n");
   }
-  if(maxEntriesA==0 || maxEntriesB==0){
+  if(maxEntries==0){
     fprintf(stderr, "Error: Empty chains.\n");
   }
   if(numEntries<0){
-    numEntries=maxEntriesA;
+    numEntries=maxEntries;
   }
   if(numEntries>0 && luminosity>0.0 && crossSection>0.0){
     scaleFactor=luminosity*crossSection/static_cast<double>(numEntries);
@@ -93,21 +205,82 @@ void EventHandler::SetScaleFactor(const double crossSection, const double lumino
   }
 }
 
-void EventHandler::GetEntry(const unsigned int entry){
-  cfA::GetEntry(entry);
+EventHandler::~EventHandler(){
+  delete stager_;
+}
+
+bool EventHandler::EnableStaging(const std::string& scratch_dir, const uint64_t budget_bytes,
+                                 const unsigned look_ahead){
+  //Event loops through GetEntry then read each ntuple from a local copy made
+  //while the previous file is processed. Pre-passes through LoadTrees still
+  //read the original files.
+  if(cfACache!=NULL){
+    std::cerr << "Warning: input is a cfA cache; not staging it." << std::endl;
+    return false;
+  }
+  if(stager_!=NULL){
+    if(staged_file_>=0) SetChainFileName(staged_file_, staged_files_.at(staged_file_));
+    delete stager_;
+    stager_=NULL;
+    staged_file_=-1;
+  }
+  staged_files_=GetInputFiles();
+  stager_=new FileStager(staged_files_, scratch_dir, budget_bytes, look_ahead);
+  if(!stager_->IsRunning()){
+    delete stager_;
+    stager_=NULL;
+    return false;
+  }
+  return true;
+}
+
+void EventHandler::StageFileOf(const unsigned entry){
+  //Points the chain element of the entry's file at its staged copy before the
+  //chains open it, and the previous element back at the original file
+  const Long64_t* const offsets(chainA.GetTreeOffset());
+  const int num_trees(chainA.GetNtrees());
+  if(offsets==NULL || num_trees<=0) return;
+  const Long64_t this_entry(entry);
+  if(staged_file_>=0 && offsets[staged_file_]<=this_entry && this_entry<offsets[staged_file_+1]) return;
+  const int file(std::upper_bound(offsets, offsets+num_trees+1, this_entry)-offsets-1);
+  if(file<0 || file>=num_trees || file>=static_cast<int>(staged_files_.size())) return;
+  if(staged_file_>=0) SetChainFileName(staged_file_, staged_files_.at(staged_file_));
+  SetChainFileName(file, stager_->Acquire(file));
+  staged_file_=file;
+}
+
+void EventHandler::SetChainFileName(const int file, const std::string& name){
+  if(file<0) return;
+  TObjArray* const files_a(chainA.GetListOfFiles());
+  TObjArray* const files_b(chainB.GetListOfFiles());
+  if(files_a!=NULL && file<files_a->GetEntries()){
+    static_cast<TChainElement*>(files_a->At(file))->SetTitle(name.c_str());
+  }
+  if(files_b!=NULL && file<files_b->GetEntries()){
+    static_cast<TChainElement*>(files_b->At(file))->SetTitle(name.c_str());
+  }
+}
+
+int EventHandler::GetEntry(const unsigned int entry){
+  if(stager_!=NULL) StageFileOf(entry);
+  const int bytes(cfA::GetEntry(entry));
   beta_cached_=false;
+  mc_truth_cached_=false;
+  trigger_decisions_cached_=false;
+  return bytes;
 }
 
 int EventHandler::GetcfAVersion() const{
-  size_t pos(sampleName.rfind("_v"));
-  if(pos!=std::string::npos && pos<(sampleName.size()-2)){
-    std::istringstream iss(sampleName.substr(pos+2));
-    int version(0);
-    iss >> version;
-    return version;
-  }else{
-    return 0;
-  }
+  return sample_traits_.cfa_version;
+}
+
+const SampleTraits& EventHandler::GetSampleTraits() const{
+  return sample_traits_;
+}
+
+void EventHandler::SetSampleName(const std::string& sample_name){
+  sampleName=sample_name;
+  sample_traits_=SampleTraits(sample_name);
 }
 
 std::vector<double> EventHandler::GetBeta(const std::string which) const{
@@ -115,7 +288,7 @@ std::vector<double> EventHandler::GetBeta(const std::string which) const{
     beta_cached_=true;
     beta_.clear();
 
-    if (GetcfAVersion()<69){
+    if (sample_traits_.cfa_version<69){
       beta_.resize(jets_AK5PF_pt->size(), 0.0);
     }else{
       for (unsigned int ijet=0; ijet<jets_AK5PF_pt->size(); ++ijet) {
@@ -193,12 +366,12 @@ bool EventHandler::PassesMETCleaningCut() const{
   //if(pfTypeImets_et->at(0)>2.0*pfmets_et->at(0)) return false;
   if(pfTypeImets_et->at(0)>2.0*mets_AK5_et->at(0)) return false; // updated 11/14 (JB-F)
   return cschalofilter_decision
-    && (hbhefilter_decision || sampleName.find("TChihh")!=std::string::npos || sampleName.find("HbbHbb")!=std::string::npos)
+    && (hbhefilter_decision || sample_traits_.skips_hbhe_filter)
     && hcallaserfilter_decision 
     && ecalTPfilter_decision 
     && trackingfailurefilter_decision 
     && eebadscfilter_decision 
-    && (ecallaserfilter_decision || sampleName.find("_v66")!=std::string::npos)
+    && (ecallaserfilter_decision || sample_traits_.skips_ecal_laser_filter)
     && greedymuonfilter_decision 
     && inconsistentPFmuonfilter_decision 
     && scrapingVeto_decision
@@ -207,27 +380,97 @@ bool EventHandler::PassesMETCleaningCut() const{
 }
 
 bool EventHandler::PassesTrigger(const std::string& trigger) const{ // just check if a specific trigger fired
-  for(unsigned int a=0; a<trigger_name->size(); ++a){
-    if(trigger_name->at(a).find(trigger)!=std::string::npos
-       && trigger_prescalevalue->at(a)==1 && trigger_decision->at(a)==1){
-      return true;
+  return PassesTrigger(trigger_index_.AddTrigger(trigger));
+}
+
+bool EventHandler::PassesTrigger(const std::size_t trigger) const{ // trigger from AddTrigger
+  UpdateTriggerDecisions();
+  return trigger_index_.Passes(trigger);
+}
+
+std::size_t EventHandler::AddTrigger(const std::vector<std::string>& patterns) const{
+  // passes if any of the patterns fired; ids are also the bits of GetTriggerMask
+  return trigger_index_.AddTrigger(patterns);
+}
+
+uint64_t EventHandler::GetTriggerMask() const{
+  UpdateTriggerDecisions();
+  return trigger_index_.GetPassedMask();
+}
+
+void EventHandler::UpdateTriggerDecisions() const{
+  if(trigger_decisions_cached_) return;
+  // the menu can only change with the file or run, so it is not hashed every event
+  const int tree(chainB.GetTreeNumber());
+  if(tree!=trigger_tree_ || run!=trigger_run_ || trigger_decision->size()!=trigger_index_.GetMenuSize()){
+    if(cfACache==NULL && b_trigger_name!=NULL && chainB.GetTree()!=NULL){
+      //Disabled for GetEntry, so read explicitly for the current entry
+      b_trigger_name->GetEntry(chainB.GetTree()->GetReadEntry(), 1);
     }
+    trigger_index_.SetMenu(*trigger_name);
+    trigger_tree_=tree;
+    trigger_run_=run;
   }
-  return false;
+  trigger_index_.SetDecisions(*trigger_decision, *trigger_prescalevalue);
+  trigger_decisions_cached_=true;
 }
 
 bool EventHandler::PassesJSONCut() const{
-  if(sampleName.find("Run2012")!=std::string::npos){
-    if(sampleName.find("PromptReco")!=std::string::npos
-       &&!inJSON(VRunLumiPrompt, run, lumiblock)) return false;
-    if(sampleName.find("24Aug")!=std::string::npos
-       && !inJSON(VRunLumi24Aug, run, lumiblock)) return false;
-    if(sampleName.find("13Jul")!=std::string::npos
-       && !inJSON(VRunLumi13Jul, run, lumiblock)) return false;
-    return true;
+  return IsCertified(run, lumiblock);
+}
+
+bool EventHandler::IsCertified(const unsigned run_in, const unsigned lumiblock_in) const{
+  if(sample_traits_.uses_prompt_reco_json
+     && !VRunLumiPrompt.Contains(run_in, lumiblock_in)) return false;
+  if(sample_traits_.uses_24aug_json
+     && !VRunLumi24Aug.Contains(run_in, lumiblock_in)) return false;
+  if(sample_traits_.uses_13jul_json
+     && !VRunLumi13Jul.Contains(run_in, lumiblock_in)) return false;
+  return true;
+}
+
+Long64_t EventHandler::LoadTrees(const int entry){
+  //Moves both chains to entry without reading it, so that single branches can be
+  //read through their b_ pointers, which the chains update whenever they open a
+  //new file. Returns the entry number within the current file.
+  const Long64_t local_entry_a(chainA.LoadTree(entry));
+  const Long64_t local_entry_b(chainB.LoadTree(entry));
+  return local_entry_a==local_entry_b?local_entry_b:-1;
+}
+
+std::vector<unsigned> EventHandler::GetCertifiedEntries(){
+  //Reads only run and lumiblock, so events in uncertified lumi sections can be
+  //skipped without decompressing the rest of the event
+  std::vector<unsigned> entries(0);
+  const int num_entries(GetTotalEntries());
+  if(num_entries<=0) return entries;
+  entries.reserve(num_entries);
+  if(!sample_traits_.is_data){
+    for(int entry(0); entry<num_entries; ++entry) entries.push_back(entry);
+  }else if(cfACache!=NULL){
+    const ColumnSpan<uint32_t> runs(cfACache->GetFile().GetSpan<uint32_t>("run"));
+    const ColumnSpan<uint32_t> lumiblocks(cfACache->GetFile().GetSpan<uint32_t>("lumiblock"));
+    if(runs.size<static_cast<uint64_t>(num_entries) || lumiblocks.size<static_cast<uint64_t>(num_entries)){
+      std::cerr << "Warning: no run and lumiblock columns in the cfA cache; using all entries." << std::endl;
+      for(int entry(0); entry<num_entries; ++entry) entries.push_back(entry);
+    }else{
+      for(int entry(0); entry<num_entries; ++entry){
+        if(IsCertified(runs.data[entry], lumiblocks.data[entry])) entries.push_back(entry);
+      }
+    }
   }else{
-    return true;
+    for(int entry(0); entry<num_entries; ++entry){
+      const Long64_t local_entry(LoadTrees(entry));
+      if(local_entry<0 || b_run==NULL || b_lumiblock==NULL){
+        entries.push_back(entry);
+        continue;
+      }
+      b_run->GetEntry(local_entry);
+      b_lumiblock->GetEntry(local_entry);
+      if(IsCertified(run, lumiblock)) entries.push_back(entry);
+    }
   }
+  return entries;
 }
 
 bool EventHandler::PassesBadJetFilter() const{
@@ -397,7 +640,7 @@ bool EventHandler::isProblemJet(const unsigned int ijet) const{
 bool EventHandler::isGoodJet(const unsigned int ijet, const bool jetid, const double ptThresh, const double etaThresh, const bool doBeta) const{
   if(jets_AK5PF_pt->at(ijet)<ptThresh || fabs(jets_AK5PF_eta->at(ijet))>etaThresh) return false;
   if( jetid && !jetPassLooseID(ijet) ) return false;
-  if(GetcfAVersion()<69||sampleName.find("SMS-TChiHH")!=std::string::npos) return true;
+  if(sample_traits_.skips_beta_cut) return true;
   if(doBeta && GetBeta().at(ijet)<0.2) return false;
   return true;
 }
@@ -602,7 +845,7 @@ int EventHandler::GetNumIsoTracks(const double ptThresh) const{
 
 int EventHandler::NewGetNumIsoTracks(const double ptThresh) const{
   int nisotracks=0;
-  if ( GetcfAVersion() < 71 ) return nisotracks;
+  if ( sample_traits_.cfa_version < 71 ) return nisotracks;
   for ( unsigned int itrack = 0 ; itrack < isotk_pt->size() ; ++itrack) {
     if ( (isotk_pt->at(itrack) >= ptThresh) &&
          (isotk_iso->at(itrack) /isotk_pt->at(itrack) < 0.1 ) &&
@@ -625,6 +868,119 @@ double EventHandler::GetNumInteractions() const{
   return npv;
 }
 
+std::vector<float> EventHandler::GetPileupProfile(const unsigned num_bins, const unsigned num_threads){
+  //Histogram of the true number of interactions with the binning of PileupWeights,
+  //read from the two pileup branches only. A cfA cache is split into blocks filled
+  //in parallel; ntuples are read in one pass since ROOT I/O stays on this thread.
+  WeightedHistogram histo(num_bins, -0.5, num_bins-0.5, num_threads>0?num_threads:1);
+  const int num_entries(GetTotalEntries());
+  if(num_entries<=0) return std::vector<float>(num_bins, 0.0);
+  if(cfACache!=NULL){
+    const ColumnarColumn* const bunch_crossings(cfACache->GetFile().GetColumn("PU_bunchCrossing"));
+    const ColumnarColumn* const true_interactions(cfACache->GetFile().GetColumn("PU_TrueNumInteractions"));
+    if(bunch_crossings==NULL || true_interactions==NULL
+       || bunch_crossings->type!=kColumnInt32 || bunch_crossings->depth!=1
+       || true_interactions->type!=kColumnFloat || true_interactions->depth!=1){
+      std::cerr << "Error: no pileup columns in the cfA cache for " << sampleName << '.' << std::endl;
+      return std::vector<float>();
+    }
+    std::vector<PileupProfileJob> jobs(histo.GetNumSlots());
+    std::vector<pthread_t> threads(jobs.size());
+    std::vector<bool> started(threads.size(), false);
+    for(std::size_t thread(0); thread<threads.size(); ++thread){
+      PileupProfileJob& job(jobs.at(thread));
+      job.bunch_crossings=bunch_crossings;
+      job.true_interactions=true_interactions;
+      job.first_entry=static_cast<uint64_t>(num_entries)*thread/threads.size();
+      job.end_entry=static_cast<uint64_t>(num_entries)*(thread+1)/threads.size();
+      job.histo=&histo;
+      job.slot=thread;
+      //A block without a thread of its own is filled here, in its own slot
+      started.at(thread)=pthread_create(&threads.at(thread), NULL, FillPileupProfile, &job)==0;
+      if(!started.at(thread)) FillPileupProfile(&job);
+    }
+    for(std::size_t thread(0); thread<threads.size(); ++thread){
+      if(started.at(thread)) pthread_join(threads.at(thread), NULL);
+    }
+  }else{
+    for(int entry(0); entry<num_entries; ++entry){
+      const Long64_t local_entry(LoadTrees(entry));
+      if(local_entry<0 || b_PU_bunchCrossing==NULL || b_PU_TrueNumInteractions==NULL) continue;
+      b_PU_bunchCrossing->GetEntry(local_entry);
+      b_PU_TrueNumInteractions->GetEntry(local_entry);
+      histo.Fill(0, GetNumInteractions(), 1.0);
+    }
+  }
+  histo.Merge();
+  std::vector<float> profile(num_bins, 0.0);
+  for(unsigned bin(0); bin<num_bins; ++bin){
+    profile.at(bin)=histo.GetSumW(bin+1);
+  }
+  return profile;
+}
+
+GeneratedEventCounts EventHandler::CountGeneratedEvents(const unsigned num_threads){
+  //Every generated event is in the ntuples, so the total is the number of
+  //entries. SMS scans are also counted per mass point from model_params alone:
+  //a cfA cache is split into blocks counted in parallel, ntuples are read in one
+  //pass since ROOT I/O stays on this thread.
+  GeneratedEventCounts counts;
+  const int num_entries(GetTotalEntries());
+  if(num_entries<=0) return counts;
+  counts.total=num_entries;
+  if(!GetSampleTraits().is_sms) return counts;
+  if(cfACache!=NULL){
+    const ColumnarColumn* const params(cfACache->GetFile().GetColumn("model_params"));
+    if(params==NULL || params->type!=kColumnChar || params->depth!=1){
+      std::cerr << "Error: no model_params column in the cfA cache for " << sampleName << '.' << std::endl;
+      return counts;
+    }
+    std::vector<MassPointJob> jobs(num_threads>0?num_threads:1);
+    std::vector<pthread_t> threads(jobs.size());
+    std::vector<bool> started(threads.size(), false);
+    for(std::size_t thread(0); thread<threads.size(); ++thread){
+      MassPointJob& job(jobs.at(thread));
+      job.model_params=params;
+      job.first_entry=static_cast<uint64_t>(num_entries)*thread/threads.size();
+      job.end_entry=static_cast<uint64_t>(num_entries)*(thread+1)/threads.size();
+      started.at(thread)=pthread_create(&threads.at(thread), NULL, CountMassPoints, &job)==0;
+      if(!started.at(thread)) CountMassPoints(&job);
+    }
+    for(std::size_t thread(0); thread<threads.size(); ++thread){
+      if(started.at(thread)) pthread_join(threads.at(thread), NULL);
+      const std::map<std::pair<int, int>, int>& job_counts(jobs.at(thread).counts);
+      for(std::map<std::pair<int, int>, int>::const_iterator point(job_counts.begin());
+          point!=job_counts.end(); ++point){
+        counts.mass_points[point->first]+=point->second;
+      }
+    }
+  }else{
+    for(int entry(0); entry<num_entries; ++entry){
+      const Long64_t local_entry(LoadTrees(entry));
+      if(local_entry<0 || b_model_params==NULL) continue;
+      b_model_params->GetEntry(local_entry);
+      ++counts.mass_points[std::make_pair(GetMass1(), GetMass2())];
+    }
+  }
+  return counts;
+}
+
+std::vector<std::string> EventHandler::GetInputFiles() const{
+  //The ntuple files of the chain, or the cache file as given to the constructor
+  std::vector<std::string> files(0);
+  if(stager_!=NULL) return staged_files_;
+  if(cfACache!=NULL){
+    files.push_back(input_name_);
+    return files;
+  }
+  const TObjArray* const elements(chainA.GetListOfFiles());
+  if(elements==NULL) return files;
+  for(int element(0); element<elements->GetEntries(); ++element){
+    files.push_back(elements->At(element)->GetTitle());
+  }
+  return files;
+}
+
 bool EventHandler::isGoodVertex(const unsigned int vertex) const{
   const double pv_rho(sqrt(pv_x->at(vertex)*pv_x->at(vertex) + pv_y->at(vertex)*pv_y->at(vertex)));
   return pv_ndof->at(vertex)>4 && fabs(pv_z->at(vertex))<24. && pv_rho<2.0 && pv_isFake->at(vertex)==0;
@@ -639,18 +995,26 @@ unsigned short EventHandler::GetNumVertices() const{
   //return pv_x->size();
 }
 
-double EventHandler::GetPUWeight(reweight::LumiReWeighting &lumiWeights) const{
+double EventHandler::GetPUWeight(const reweight::LumiReWeighting &lumiWeights) const{
   return lumiWeights.weight(GetNumInteractions());
 }
 
+const McTruthIndex& EventHandler::GetMcTruth() const{
+  if(!mc_truth_cached_){
+    mc_truth_.Build(*mc_doc_id, *mc_doc_mother_id, *mc_doc_grandmother_id);
+    mc_truth_cached_=true;
+  }
+  return mc_truth_;
+}
+
 double EventHandler::GetTopPt() const {
-  double topPt(-1);
-  for(unsigned int i(0); i<mc_doc_id->size(); ++i){
-    // look for the *top* (not antitop) pT
-    if(mc_doc_id->at(i)==6) topPt = mc_doc_pt->at(i);
-    if(topPt>=0) break; //check to see if we're done
+  // look for the *top* (not antitop) pT
+  const McTruthIndex& truth(GetMcTruth());
+  const std::vector<unsigned>& tops(truth.GetParticles(McTruthIndex::kTops));
+  for(unsigned int i(0); i<tops.size(); ++i){
+    if(truth.GetId(tops.at(i))==6) return mc_doc_pt->at(tops.at(i));
   }
-  return topPt;
+  return -1.0;
 }
 
 double EventHandler::GetTopPtWeight() const{ // New 11/07
@@ -659,14 +1023,14 @@ double EventHandler::GetTopPtWeight() const{ // New 11/07
 
   //official recipe from
   // https://twiki.cern.ch/twiki/bin/viewauth/CMS/TopPtReweighting
-  //(2 string comparisons for every event is not so good for performance, but oh well)
-  if (sampleName.find("TTJets")!=std::string::npos || sampleName.find("TT_")!=std::string::npos) {
+  if (sample_traits_.is_ttbar) {
     double topPt(-1);
     double topbarPt(-1);
-    for(unsigned int i(0); i<mc_doc_id->size(); ++i){
-      // look for the *top* (not antitop) pT
-      if(mc_doc_id->at(i)==6) topPt = mc_doc_pt->at(i);
-      if(mc_doc_id->at(i)==-6) topbarPt = mc_doc_pt->at(i);
+    const McTruthIndex& truth(GetMcTruth());
+    const std::vector<unsigned>& tops(truth.GetParticles(McTruthIndex::kTops));
+    for(unsigned int i(0); i<tops.size(); ++i){
+      if(truth.GetId(tops.at(i))==6) topPt = mc_doc_pt->at(tops.at(i));
+      if(truth.GetId(tops.at(i))==-6) topbarPt = mc_doc_pt->at(tops.at(i));
       if(topPt>=0 && topbarPt>=0) break; //check to see if we're done
     }
 
@@ -720,24 +1084,11 @@ double EventHandler::GetHighestJetCSV(const unsigned int nth_highest) const{
 }
 
 int EventHandler::GetMass1() const{
-  const std::string::size_type p1(model_params->find('_'));
-  const std::string::size_type p2(model_params->find('_',p1+1));
-  if(p1!=std::string::npos && p2!=std::string::npos){
-    return atoi(model_params->substr(p1+1,p2-p1-1).c_str());
-  }else{
-    return -1;
-  }
+  return ParseMass1(*model_params);
 }
 
 int EventHandler::GetMass2() const{
-  const std::string::size_type p1(model_params->find('_'));
-  const std::string::size_type p2(model_params->find('_',p1+1));
-  const std::string::size_type p3(model_params->find(' ',p2+1));
-  if(p2!=std::string::npos && p3!=std::string::npos){
-    return atoi(model_params->substr(p2+1,p3-p2-1).c_str());
-  }else{
-    return -1;
-  }
+  return ParseMass2(*model_params);
 }
 
 double EventHandler::GetMT2(const double test_mass) const{
@@ -902,15 +1253,11 @@ double EventHandler::GetDeltaPhiWLepton() const{
 }
 
 unsigned EventHandler::GetNumberOfGeneratedEMu(const bool check_W, const bool check_top) const{
-  unsigned count(0);
-  for(unsigned particle(0); particle<mc_doc_id->size(); ++particle){
-    if((fabs(mc_doc_id->at(particle))==11.0 || fabs(mc_doc_id->at(particle))==13)
-       && (fabs(mc_doc_mother_id->at(particle))==24.0 || !check_W)
-       && (fabs(mc_doc_grandmother_id->at(particle))==6.0 || !check_top)){
-      ++count;
-    }
-  }
-  return count;
+  return GetMcTruth().GetNumEMu(check_W, check_top);
+}
+
+McTruthIndex::TtbarDecay EventHandler::GetTtbarDecay() const{
+  return GetMcTruth().GetTtbarDecay();
 }
 
 std::vector<double> EventHandler::GetBLInvariantMasses(const unsigned num_bs, const double csv_cut){
@@ -0,0 +1,425 @@
+#include "event_handler_benchmark.hpp"
+#include <cmath>
+#include <string>
+#include <vector>
+#include <limits>
+#include <iomanip>
+#include <ostream>
+#include "math.hpp"
+#include "TRandom3.h"
+#include "event_handler.hpp"
+#include "pu_constants.hpp"
+#include "timer.hpp"
+
+namespace{
+  template<typename T>
+  void Push(std::vector<T>* values, const double value){
+    values->push_back(static_cast<T>(value));
+  }
+
+  template<typename T>
+  void Set(T& member, const double value){
+    member=static_cast<T>(value);
+  }
+}
+
+EventHandlerBenchmark::EventHandlerBenchmark(const std::string& sample_name, const unsigned seed):
+  EventHandler(sample_name),
+  random_(seed),
+  lumi_weights_(std::vector<float>(pu::Summer2012_S10, pu::Summer2012_S10+60),
+                std::vector<float>(pu::RunsThrough203002, pu::RunsThrough203002+60)),
+  weight_calculator_(19399.0),
+  data_sample_name_("SingleMu_Run2012C-PromptReco-v2_AOD_UCSB1541_v71"){
+}
+
+const char* EventHandlerBenchmark::GetBenchmarkName(const Benchmark benchmark){
+  switch(benchmark){
+  case kTimerOverhead: return "timer_overhead";
+  case kGetBeta: return "GetBeta";
+  case kIsGoodJet: return "isGoodJet";
+  case kIsElectron: return "isElectron";
+  case kIsMuon: return "isMuon";
+  case kIsTau: return "isTau";
+  case kGetNumIsoTracks: return "GetNumIsoTracks";
+  case kNewGetNumIsoTracks: return "NewGetNumIsoTracks";
+  case kGetNumVertices: return "GetNumVertices";
+  case kPassesJSONCut: return "PassesJSONCut";
+  case kPassesMETCleaningCut: return "PassesMETCleaningCut";
+  case kPassesLeptonCut: return "PassesLeptonCut";
+  case kGetHT: return "GetHT";
+  case kGetMT2: return "GetMT2";
+  case kGetMT: return "GetMT";
+  case kGetBLInvariantMasses: return "GetBLInvariantMasses";
+  case kGetNumberOfGeneratedEMu: return "GetNumberOfGeneratedEMu";
+  case kGetTopPtWeight: return "GetTopPtWeight";
+  case kGetPUWeight: return "GetPUWeight";
+  case kGetWeight: return "WeightCalculator::GetWeight";
+  case kNumBenchmarks:
+  default: return "unknown";
+  }
+}
+
+void EventHandlerBenchmark::GenerateEvent(){
+  Set(run, random_.Uniform(190456.0, 208686.0));
+  Set(lumiblock, random_.Uniform(1.0, 1000.0));
+  Set(event, random_.Uniform(1.0, 1.e9));
+  Set(rho_kt6PFJetsForIsolation2012, random_.Uniform(5.0, 25.0));
+
+  const bool filters(random_.Rndm()<0.99);
+  Set(cschalofilter_decision, filters);
+  Set(hbhefilter_decision, filters);
+  Set(hcallaserfilter_decision, filters);
+  Set(ecalTPfilter_decision, filters);
+  Set(trackingfailurefilter_decision, filters);
+  Set(eebadscfilter_decision, filters);
+  Set(ecallaserfilter_decision, filters);
+  Set(greedymuonfilter_decision, filters);
+  Set(inconsistentPFmuonfilter_decision, filters);
+  Set(scrapingVeto_decision, filters);
+
+  const double met(random_.Exp(80.0)), met_phi(random_.Uniform(-Math::pi, Math::pi));
+  pfTypeImets_et->clear(); pfTypeImets_ex->clear(); pfTypeImets_ey->clear(); pfTypeImets_phi->clear();
+  mets_AK5_et->clear();
+  Push(pfTypeImets_et, met);
+  Push(pfTypeImets_ex, met*cos(met_phi));
+  Push(pfTypeImets_ey, met*sin(met_phi));
+  Push(pfTypeImets_phi, met_phi);
+  Push(mets_AK5_et, met*random_.Uniform(0.8, 1.2));
+  Set(pfmets_fullSignif, random_.Exp(20.0));
+
+  GenerateVertices();
+  GenerateJets();
+  GenerateLeptons();
+  GenerateTracks();
+  GenerateGeneratorInfo();
+}
+
+void EventHandlerBenchmark::GenerateVertices(){
+  beamSpot_x->clear(); beamSpot_y->clear();
+  Push(beamSpot_x, 0.07);
+  Push(beamSpot_y, 0.06);
+
+  pv_x->clear(); pv_y->clear(); pv_z->clear(); pv_ndof->clear(); pv_isFake->clear();
+  const int num_vertices(1+random_.Poisson(19.0));
+  for(int vertex(0); vertex<num_vertices; ++vertex){
+    Push(pv_x, 0.07+random_.Gaus(0.0, 0.02));
+    Push(pv_y, 0.06+random_.Gaus(0.0, 0.02));
+    Push(pv_z, random_.Gaus(0.0, 5.0));
+    Push(pv_ndof, random_.Uniform(0.0, 150.0));
+    Push(pv_isFake, 0.0);
+  }
+
+  PU_bunchCrossing->clear(); PU_TrueNumInteractions->clear();
+  const double true_num_interactions(std::max(0.0, random_.Gaus(20.0, 5.0)));
+  for(int bunch_crossing(-1); bunch_crossing<=1; ++bunch_crossing){
+    Push(PU_bunchCrossing, bunch_crossing);
+    Push(PU_TrueNumInteractions, true_num_interactions);
+  }
+}
+
+void EventHandlerBenchmark::GenerateJets(){
+  jets_AK5PF_pt->clear(); jets_AK5PF_eta->clear(); jets_AK5PF_phi->clear();
+  jets_AK5PF_px->clear(); jets_AK5PF_py->clear(); jets_AK5PF_pz->clear();
+  jets_AK5PF_energy->clear(); jets_AK5PF_mass->clear(); jets_AK5PF_corrFactorRaw->clear();
+  jets_AK5PF_neutralHadE->clear(); jets_AK5PF_neutralEmE->clear();
+  jets_AK5PF_chgHadE->clear(); jets_AK5PF_chgEmE->clear(); jets_AK5PF_photonEnergy->clear();
+  jets_AK5PF_mu_Mult->clear(); jets_AK5PF_neutral_Mult->clear(); jets_AK5PF_chg_Mult->clear();
+  jets_AK5PF_btag_secVertexCombined->clear();
+  puJet_rejectionBeta->clear();
+
+  const int num_jets(2+random_.Poisson(5.0));
+  for(int jet(0); jet<num_jets; ++jet){
+    const float pt(20.0+random_.Exp(50.0));
+    const float eta(random_.Gaus(0.0, 1.5));
+    const double phi(random_.Uniform(-Math::pi, Math::pi));
+    const double mass(random_.Uniform(2.0, 20.0));
+    const double p(pt*cosh(eta));
+    const double energy(sqrt(p*p+mass*mass));
+    const double raw_factor(random_.Uniform(0.8, 1.0));
+    const double charged_hadron(random_.Uniform(0.3, 0.7)), neutral_hadron(random_.Uniform(0.0, 0.3));
+    const double charged_em(random_.Uniform(0.0, 0.1));
+    const double neutral_em(1.0-charged_hadron-neutral_hadron-charged_em);
+    Push(jets_AK5PF_pt, pt);
+    Push(jets_AK5PF_eta, eta);
+    Push(jets_AK5PF_phi, phi);
+    Push(jets_AK5PF_px, pt*cos(phi));
+    Push(jets_AK5PF_py, pt*sin(phi));
+    Push(jets_AK5PF_pz, pt*sinh(eta));
+    Push(jets_AK5PF_energy, energy);
+    Push(jets_AK5PF_mass, mass);
+    Push(jets_AK5PF_corrFactorRaw, raw_factor);
+    Push(jets_AK5PF_chgHadE, charged_hadron*energy*raw_factor);
+    Push(jets_AK5PF_neutralHadE, neutral_hadron*energy*raw_factor);
+    Push(jets_AK5PF_chgEmE, charged_em*energy*raw_factor);
+    Push(jets_AK5PF_neutralEmE, neutral_em*energy*raw_factor);
+    Push(jets_AK5PF_photonEnergy, neutral_em*energy*raw_factor);
+    Push(jets_AK5PF_mu_Mult, random_.Poisson(0.1));
+    Push(jets_AK5PF_neutral_Mult, random_.Poisson(8.0));
+    Push(jets_AK5PF_chg_Mult, random_.Poisson(12.0));
+    Push(jets_AK5PF_btag_secVertexCombined, random_.Rndm()<0.25?random_.Uniform(0.7, 1.0):random_.Uniform(0.0, 0.7));
+
+    //pt, |eta|, beta, betaStar, betaClassic, betaStarClassic, matched to the jet by pt and eta
+    std::vector<float> beta(6, 0.0);
+    beta.at(0)=pt;
+    beta.at(1)=eta;
+    for(unsigned i(2); i<beta.size(); ++i){
+      beta.at(i)=random_.Uniform(0.1, 1.0);
+    }
+    puJet_rejectionBeta->push_back(beta);
+  }
+}
+
+void EventHandlerBenchmark::GenerateLeptons(){
+  pf_els_pt->clear(); pf_els_px->clear(); pf_els_py->clear(); pf_els_pz->clear();
+  pf_els_energy->clear(); pf_els_phi->clear(); pf_els_scEta->clear();
+  pf_els_isEB->clear(); pf_els_isEE->clear();
+  pf_els_dEtaIn->clear(); pf_els_dPhiIn->clear(); pf_els_sigmaIEtaIEta->clear(); pf_els_hadOverEm->clear();
+  pf_els_d0dum->clear(); pf_els_tk_phi->clear(); pf_els_vz->clear();
+  pf_els_PFphotonIsoR03->clear(); pf_els_PFneutralHadronIsoR03->clear(); pf_els_PFchargedHadronIsoR03->clear();
+  const int num_electrons(random_.Poisson(0.7));
+  for(int electron(0); electron<num_electrons; ++electron){
+    const double pt(10.0+random_.Exp(30.0)), eta(random_.Uniform(-2.6, 2.6));
+    const double phi(random_.Uniform(-Math::pi, Math::pi));
+    const bool barrel(fabs(eta)<1.479);
+    Push(pf_els_pt, pt);
+    Push(pf_els_px, pt*cos(phi));
+    Push(pf_els_py, pt*sin(phi));
+    Push(pf_els_pz, pt*sinh(eta));
+    Push(pf_els_energy, pt*cosh(eta));
+    Push(pf_els_phi, phi);
+    Push(pf_els_scEta, eta);
+    Push(pf_els_isEB, barrel);
+    Push(pf_els_isEE, !barrel);
+    Push(pf_els_dEtaIn, random_.Gaus(0.0, 0.004));
+    Push(pf_els_dPhiIn, random_.Gaus(0.0, 0.03));
+    Push(pf_els_sigmaIEtaIEta, barrel?random_.Uniform(0.005, 0.012):random_.Uniform(0.02, 0.032));
+    Push(pf_els_hadOverEm, random_.Exp(0.05));
+    Push(pf_els_d0dum, random_.Gaus(0.0, 0.01));
+    Push(pf_els_tk_phi, phi);
+    Push(pf_els_vz, pv_z->at(0)+random_.Gaus(0.0, 0.05));
+    Push(pf_els_PFphotonIsoR03, random_.Exp(0.03*pt));
+    Push(pf_els_PFneutralHadronIsoR03, random_.Exp(0.03*pt));
+    Push(pf_els_PFchargedHadronIsoR03, random_.Exp(0.05*pt));
+  }
+
+  pf_mus_pt->clear(); pf_mus_px->clear(); pf_mus_py->clear(); pf_mus_pz->clear();
+  pf_mus_energy->clear(); pf_mus_phi->clear(); pf_mus_eta->clear();
+  pf_mus_id_GlobalMuonPromptTight->clear(); pf_mus_numberOfMatchedStations->clear();
+  pf_mus_tk_d0dum->clear(); pf_mus_tk_phi->clear(); pf_mus_tk_vz->clear();
+  pf_mus_tk_numvalPixelhits->clear(); pf_mus_tk_LayersWithMeasurement->clear();
+  pf_mus_pfIsolationR04_sumNeutralHadronEt->clear(); pf_mus_pfIsolationR04_sumPhotonEt->clear();
+  pf_mus_pfIsolationR04_sumPUPt->clear(); pf_mus_pfIsolationR04_sumChargedHadronPt->clear();
+  const int num_muons(random_.Poisson(0.7));
+  for(int muon(0); muon<num_muons; ++muon){
+    const double pt(10.0+random_.Exp(30.0)), eta(random_.Uniform(-2.5, 2.5));
+    const double phi(random_.Uniform(-Math::pi, Math::pi));
+    Push(pf_mus_pt, pt);
+    Push(pf_mus_px, pt*cos(phi));
+    Push(pf_mus_py, pt*sin(phi));
+    Push(pf_mus_pz, pt*sinh(eta));
+    Push(pf_mus_energy, pt*cosh(eta));
+    Push(pf_mus_phi, phi);
+    Push(pf_mus_eta, eta);
+    Push(pf_mus_id_GlobalMuonPromptTight, random_.Rndm()<0.95);
+    Push(pf_mus_numberOfMatchedStations, 1+random_.Poisson(1.5));
+    Push(pf_mus_tk_d0dum, random_.Gaus(0.0, 0.02));
+    Push(pf_mus_tk_phi, phi);
+    Push(pf_mus_tk_vz, pv_z->at(0)+random_.Gaus(0.0, 0.1));
+    Push(pf_mus_tk_numvalPixelhits, random_.Poisson(3.0));
+    Push(pf_mus_tk_LayersWithMeasurement, 4+random_.Poisson(6.0));
+    Push(pf_mus_pfIsolationR04_sumNeutralHadronEt, random_.Exp(0.03*pt));
+    Push(pf_mus_pfIsolationR04_sumPhotonEt, random_.Exp(0.03*pt));
+    Push(pf_mus_pfIsolationR04_sumPUPt, random_.Exp(0.03*pt));
+    Push(pf_mus_pfIsolationR04_sumChargedHadronPt, random_.Exp(0.05*pt));
+  }
+
+  taus_pt->clear(); taus_eta->clear(); taus_byLooseIsolationDeltaBetaCorr->clear();
+  const int num_taus(random_.Poisson(1.0));
+  for(int tau(0); tau<num_taus; ++tau){
+    Push(taus_pt, 15.0+random_.Exp(20.0));
+    Push(taus_eta, random_.Uniform(-2.6, 2.6));
+    Push(taus_byLooseIsolationDeltaBetaCorr, random_.Rndm()<0.3);
+  }
+}
+
+void EventHandlerBenchmark::GenerateTracks(){
+  tracks_pt->clear(); tracks_eta->clear(); tracks_phi->clear();
+  tracks_vz->clear(); tracks_chi2->clear(); tracks_highPurity->clear();
+  const int num_tracks(random_.Poisson(50.0));
+  for(int track(0); track<num_tracks; ++track){
+    Push(tracks_pt, 1.0+random_.Exp(5.0));
+    Push(tracks_eta, random_.Uniform(-2.6, 2.6));
+    Push(tracks_phi, random_.Uniform(-Math::pi, Math::pi));
+    Push(tracks_vz, pv_z->at(0)+random_.Gaus(0.0, 0.03));
+    Push(tracks_chi2, random_.Uniform(0.0, 3.0));
+    Push(tracks_highPurity, random_.Rndm()<0.9);
+  }
+
+  isotk_pt->clear(); isotk_iso->clear(); isotk_dzpv->clear(); isotk_eta->clear();
+  const int num_iso_tracks(random_.Poisson(2.0));
+  for(int track(0); track<num_iso_tracks; ++track){
+    Push(isotk_pt, 10.0+random_.Exp(10.0));
+    Push(isotk_iso, random_.Exp(2.0));
+    Push(isotk_dzpv, random_.Gaus(0.0, 0.05));
+    Push(isotk_eta, random_.Uniform(-2.6, 2.6));
+  }
+}
+
+void EventHandlerBenchmark::GenerateGeneratorInfo(){
+  //ttbar with each W decaying to e, mu, tau or quarks, plus some unrelated partons
+  mc_doc_id->clear(); mc_doc_pt->clear(); mc_doc_mother_id->clear(); mc_doc_grandmother_id->clear();
+  for(int sign(1); sign>=-1; sign-=2){
+    Push(mc_doc_id, 6*sign); Push(mc_doc_pt, random_.Exp(100.0));
+    Push(mc_doc_mother_id, 21); Push(mc_doc_grandmother_id, 2212);
+    Push(mc_doc_id, 5*sign); Push(mc_doc_pt, random_.Exp(60.0));
+    Push(mc_doc_mother_id, 6*sign); Push(mc_doc_grandmother_id, 21);
+    Push(mc_doc_id, 24*sign); Push(mc_doc_pt, random_.Exp(60.0));
+    Push(mc_doc_mother_id, 6*sign); Push(mc_doc_grandmother_id, 21);
+    const double decay(random_.Rndm());
+    int first(1), second(2);
+    if(decay<1.0/9.0){
+      first=11; second=12;
+    }else if(decay<2.0/9.0){
+      first=13; second=14;
+    }else if(decay<3.0/9.0){
+      first=15; second=16;
+    }
+    Push(mc_doc_id, -first*sign); Push(mc_doc_pt, random_.Exp(40.0));
+    Push(mc_doc_mother_id, 24*sign); Push(mc_doc_grandmother_id, 6*sign);
+    Push(mc_doc_id, second*sign); Push(mc_doc_pt, random_.Exp(40.0));
+    Push(mc_doc_mother_id, 24*sign); Push(mc_doc_grandmother_id, 6*sign);
+  }
+  const int num_extra(random_.Poisson(20.0));
+  for(int particle(0); particle<num_extra; ++particle){
+    Push(mc_doc_id, random_.Rndm()<0.5?21:1+random_.Integer(4));
+    Push(mc_doc_pt, random_.Exp(20.0));
+    Push(mc_doc_mother_id, 2212);
+    Push(mc_doc_grandmother_id, 0);
+  }
+}
+
+double EventHandlerBenchmark::RunBenchmark(const Benchmark benchmark){
+  //Returns a value depending on the result so that the work cannot be optimized away
+  double result(0.0);
+  switch(benchmark){
+  case kTimerOverhead:
+    break;
+  case kGetBeta:
+    result=GetBeta().size();
+    break;
+  case kIsGoodJet:
+    for(unsigned jet(0); jet<jets_AK5PF_pt->size(); ++jet){
+      if(isGoodJet(jet)) ++result;
+    }
+    break;
+  case kIsElectron:
+    for(unsigned short level(0); level<=3; ++level){
+      for(unsigned electron(0); electron<pf_els_pt->size(); ++electron){
+        if(isElectron(electron, level)) ++result;
+      }
+    }
+    break;
+  case kIsMuon:
+    for(unsigned short level(0); level<=3; ++level){
+      for(unsigned muon(0); muon<pf_mus_pt->size(); ++muon){
+        if(isMuon(muon, level)) ++result;
+      }
+    }
+    break;
+  case kIsTau:
+    for(unsigned short level(0); level<=1; ++level){
+      for(unsigned tau(0); tau<taus_pt->size(); ++tau){
+        if(isTau(tau, level)) ++result;
+      }
+    }
+    break;
+  case kGetNumIsoTracks:
+    result=GetNumIsoTracks();
+    break;
+  case kNewGetNumIsoTracks:
+    result=NewGetNumIsoTracks();
+    break;
+  case kGetNumVertices:
+    result=GetNumVertices();
+    break;
+  case kPassesJSONCut:
+    result=PassesJSONCut();
+    break;
+  case kPassesMETCleaningCut:
+    result=PassesMETCleaningCut();
+    break;
+  case kPassesLeptonCut:
+    result=PassesLeptonCut();
+    break;
+  case kGetHT:
+    result=GetHT(false, false);
+    break;
+  case kGetMT2:
+    result=GetMT2(80.399);
+    break;
+  case kGetMT:
+    result=GetMT();
+    break;
+  case kGetBLInvariantMasses:
+    {
+      const std::vector<double> masses(GetBLInvariantMasses(2, -std::numeric_limits<float>::max()));
+      for(unsigned i(0); i<masses.size(); ++i) result+=masses.at(i);
+    }
+    break;
+  case kGetNumberOfGeneratedEMu:
+    result=GetNumberOfGeneratedEMu(true, true);
+    break;
+  case kGetTopPtWeight:
+    result=GetTopPtWeight();
+    break;
+  case kGetPUWeight:
+    result=GetPUWeight(lumi_weights_);
+    break;
+  case kGetWeight:
+    result=weight_calculator_.GetWeight(sampleName);
+    break;
+  case kNumBenchmarks:
+  default:
+    break;
+  }
+  return result;
+}
+
+void EventHandlerBenchmark::Run(const unsigned num_events, std::ostream& out){
+  Timer timer(num_events);
+  std::vector<unsigned> sections(kNumBenchmarks);
+  for(int benchmark(0); benchmark<kNumBenchmarks; ++benchmark){
+    sections.at(benchmark)=timer.AddSection(GetBenchmarkName(static_cast<Benchmark>(benchmark)));
+  }
+  std::vector<double> checksums(kNumBenchmarks, 0.0);
+
+  const std::string mc_sample_name(sampleName);
+  timer.Start();
+  for(unsigned event_num(0); event_num<num_events; ++event_num){
+    GenerateEvent();
+    GetEntry(0);//Resets the per-event caches; with no input the generated values are left alone
+    for(int benchmark(0); benchmark<kNumBenchmarks; ++benchmark){
+      //PassesJSONCut only does any work for data
+      if(benchmark==kPassesJSONCut) SetSampleName(data_sample_name_);
+      {
+        const ScopedTimer scope(timer, sections.at(benchmark));
+        checksums.at(benchmark)+=RunBenchmark(static_cast<Benchmark>(benchmark));
+      }
+      if(benchmark==kPassesJSONCut) SetSampleName(mc_sample_name);
+    }
+  }
+
+  const double overhead(num_events?1.e9*timer.GetSectionTime(sections.at(kTimerOverhead))/num_events:0.0);
+  out << "# sample: " << sampleName << '\n'
+      << "# events: " << num_events << '\n'
+      << "# benchmark\tns_per_event\traw_ns_per_event\tevents\tchecksum\n";
+  out << std::fixed;
+  for(int benchmark(0); benchmark<kNumBenchmarks; ++benchmark){
+    const double raw(num_events?1.e9*timer.GetSectionTime(sections.at(benchmark))/num_events:0.0);
+    const double corrected(benchmark==kTimerOverhead?raw:std::max(0.0, raw-overhead));
+    out << timer.GetSectionName(sections.at(benchmark)) << '\t'
+        << std::setprecision(1) << corrected << '\t' << raw << '\t'
+        << num_events << '\t' << std::setprecision(6) << checksums.at(benchmark) << '\n';
+  }
+  out.flush();
+}
@@ -0,0 +1,23 @@
+/*
+  Writes an uncompressed, memory-mappable columnar copy of reduced_tree files for fast repeated scans (see reduced_tree_columns.hpp).
+  Input: any number of reduced_tree format .root files given as arguments
+  Output: for each input file x.root, a file x.columns in the same directory
+  Options: None
+*/
+
+#include <iostream>
+#include <string>
+#include "reduced_tree_columns.hpp"
+
+int main(int argc, char *argv[]){
+  int status(0);
+  for(int arg(1); arg<argc; ++arg){
+    const std::string out_name(GetReducedTreeColumnsName(argv[arg]));
+    if(ExportReducedTree(argv[arg], out_name)){
+      std::cout << "Wrote " << out_name << std::endl;
+    }else{
+      status=1;
+    }
+  }
+  return status;
+}
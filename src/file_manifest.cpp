@@ -0,0 +1,179 @@
+#include "file_manifest.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <stdint.h>
+#include <unistd.h>
+#include <glob.h>
+#include <sys/stat.h>
+#include "cache_io.hpp"
+
+namespace{
+  uint64_t HashInput(const std::string& input, const bool is_list){
+    //Over the pattern or list name and the list flag
+    CacheHash hash;
+    hash.Add(input);
+    hash.AddByte(is_list?1:0);
+    return hash.Get();
+  }
+}
+
+FileManifest::FileManifest(const std::string& input, const bool is_list,
+                           const std::string& cache_dir):
+  input_(input),
+  manifest_name_(""),
+  files_(0),
+  modified_(false){
+  struct stat dir_stat;
+  if(cache_dir!="" && stat(cache_dir.c_str(), &dir_stat)==0 && S_ISDIR(dir_stat.st_mode)){
+    std::ostringstream name("");
+    name << cache_dir << "/manifest_" << std::hex;
+    name.width(16);
+    name.fill('0');
+    name << HashInput(input, is_list) << ".txt";
+    manifest_name_=name.str();
+  }
+
+  const std::vector<std::string> names(ExpandInput(input, is_list));
+  files_.resize(names.size());
+  for(std::size_t file(0); file<names.size(); ++file){
+    FileInfo& info(files_.at(file));
+    info.name=names.at(file);
+    info.size=-1;
+    info.mtime=-1;
+    info.entries_a=-1;
+    info.entries_b=-1;
+    info.known=false;
+    struct stat file_stat;
+    info.exists=stat(info.name.c_str(), &file_stat)==0;
+    if(info.exists){
+      info.size=file_stat.st_size;
+      info.mtime=file_stat.st_mtime;
+    }
+  }
+  Load();
+}
+
+std::size_t FileManifest::GetNumFiles() const{
+  return files_.size();
+}
+
+const std::string& FileManifest::GetFileName(const std::size_t file) const{
+  return files_.at(file).name;
+}
+
+bool FileManifest::IsKnown(const std::size_t file) const{
+  return files_.at(file).known;
+}
+
+int64_t FileManifest::GetEntriesA(const std::size_t file) const{
+  return files_.at(file).entries_a;
+}
+
+int64_t FileManifest::GetEntriesB(const std::size_t file) const{
+  return files_.at(file).entries_b;
+}
+
+int64_t FileManifest::GetTreeOffset(const std::size_t file) const{
+  int64_t offset(0);
+  for(std::size_t earlier(0); earlier<file && earlier<files_.size(); ++earlier){
+    if(!files_.at(earlier).known) return -1;
+    offset+=files_.at(earlier).entries_a;
+  }
+  return offset;
+}
+
+std::size_t FileManifest::GetNumKnown() const{
+  std::size_t num_known(0);
+  for(std::size_t file(0); file<files_.size(); ++file){
+    if(files_.at(file).known) ++num_known;
+  }
+  return num_known;
+}
+
+void FileManifest::SetEntries(const std::size_t file, const int64_t entries_a, const int64_t entries_b){
+  //Files that cannot be stat'ed (e.g. remote URLs) are never trusted later, so
+  //their counts are kept for this job only
+  FileInfo& info(files_.at(file));
+  info.entries_a=entries_a;
+  info.entries_b=entries_b;
+  info.known=true;
+  if(info.exists) modified_=true;
+}
+
+bool FileManifest::Save(){
+  if(!modified_ || manifest_name_=="") return true;
+  AtomicFileWriter writer(manifest_name_);
+  std::ofstream& out(writer.GetStream());
+  out << "# " << input_ << '\n';
+  for(std::size_t file(0); file<files_.size(); ++file){
+    const FileInfo& info(files_.at(file));
+    if(!info.known || !info.exists) continue;
+    out << info.size << ' ' << info.mtime << ' ' << info.entries_a << ' '
+        << info.entries_b << ' ' << info.name << '\n';
+  }
+  if(!writer.Commit()){
+    std::cerr << "Warning: could not write file manifest " << manifest_name_ << '.' << std::endl;
+    return false;
+  }
+  modified_=false;
+  return true;
+}
+
+const std::string& FileManifest::GetManifestName() const{
+  return manifest_name_;
+}
+
+std::vector<std::string> FileManifest::ExpandInput(const std::string& input, const bool is_list){
+  //Same files, in the same order, as TChain::Add would chain: a list is taken as
+  //is, a pattern is expanded in sorted order
+  std::vector<std::string> names(0);
+  if(is_list){
+    std::ifstream list(input.c_str());
+    std::string name("");
+    while(list >> name) names.push_back(name);
+    return names;
+  }
+  if(input.find_first_of("*?[")==std::string::npos){
+    names.push_back(input);
+    return names;
+  }
+  glob_t matches;
+  if(glob(input.c_str(), 0, NULL, &matches)==0){
+    for(std::size_t match(0); match<matches.gl_pathc; ++match){
+      names.push_back(matches.gl_pathv[match]);
+    }
+  }
+  globfree(&matches);
+  return names;
+}
+
+void FileManifest::Load(){
+  if(manifest_name_=="") return;
+  std::ifstream in(manifest_name_.c_str());
+  if(!in.is_open()) return;
+  std::map<std::string, FileInfo> cached;
+  std::string line("");
+  while(std::getline(in, line)){
+    if(line.size()==0 || line[0]=='#') continue;
+    std::istringstream fields(line);
+    FileInfo info;
+    if(!(fields >> info.size >> info.mtime >> info.entries_a >> info.entries_b)) continue;
+    fields.get();
+    std::getline(fields, info.name);
+    if(info.name!="") cached[info.name]=info;
+  }
+  for(std::size_t file(0); file<files_.size(); ++file){
+    FileInfo& info(files_.at(file));
+    if(!info.exists) continue;
+    const std::map<std::string, FileInfo>::const_iterator match(cached.find(info.name));
+    if(match==cached.end() || match->second.size!=info.size || match->second.mtime!=info.mtime) continue;
+    info.entries_a=match->second.entries_a;
+    info.entries_b=match->second.entries_b;
+    info.known=true;
+  }
+}
@@ -0,0 +1,214 @@
+#include "file_stager.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iostream>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+
+namespace{
+  const std::size_t copy_chunk_size(1<<22);
+  //Space left free on the scratch disk for everyone else
+  const uint64_t scratch_reserve_bytes(static_cast<uint64_t>(1)<<28);
+
+  std::string GetBaseName(const std::string& name){
+    const std::string::size_type slash(name.rfind('/'));
+    return slash==std::string::npos?name:name.substr(slash+1);
+  }
+}
+
+FileStager::FileStager(const std::vector<std::string>& files,
+                       const std::string& scratch_dir,
+                       const uint64_t budget_bytes,
+                       const unsigned look_ahead):
+  files_(files.size()),
+  scratch_dir_(scratch_dir),
+  budget_bytes_(budget_bytes),
+  used_bytes_(0),
+  look_ahead_(look_ahead>0?look_ahead:1),
+  current_(0),
+  num_staged_(0),
+  num_direct_(0),
+  stop_(false),
+  running_(false),
+  mutex_(),
+  changed_(),
+  thread_(){
+  for(std::size_t file(0); file<files.size(); ++file){
+    StagedFile& staged(files_.at(file));
+    staged.name=files.at(file);
+    std::ostringstream local_name("");
+    local_name << scratch_dir << "/stage_" << getpid() << '_' << file << '_' << GetBaseName(staged.name);
+    staged.local_name=local_name.str();
+    struct stat file_stat;
+    if(stat(staged.name.c_str(), &file_stat)==0 && S_ISREG(file_stat.st_mode)){
+      staged.size=file_stat.st_size;
+      staged.state=kPending;
+    }else{
+      //Not a local file (e.g. a URL): always read directly
+      staged.size=0;
+      staged.state=kDirect;
+    }
+  }
+  pthread_mutex_init(&mutex_, NULL);
+  pthread_cond_init(&changed_, NULL);
+  struct stat dir_stat;
+  if(stat(scratch_dir.c_str(), &dir_stat)!=0 || !S_ISDIR(dir_stat.st_mode)
+     || access(scratch_dir.c_str(), W_OK)!=0){
+    std::cerr << "Warning: scratch directory " << scratch_dir << " is not writable; reading input directly." << std::endl;
+  }else{
+    running_=pthread_create(&thread_, NULL, Run, this)==0;
+  }
+}
+
+FileStager::~FileStager(){
+  pthread_mutex_lock(&mutex_);
+  stop_=true;
+  pthread_cond_broadcast(&changed_);
+  pthread_mutex_unlock(&mutex_);
+  if(running_) pthread_join(thread_, NULL);
+  for(std::size_t file(0); file<files_.size(); ++file){
+    Delete(files_.at(file));
+  }
+  pthread_cond_destroy(&changed_);
+  pthread_mutex_destroy(&mutex_);
+}
+
+bool FileStager::IsRunning() const{
+  return running_;
+}
+
+std::string FileStager::Acquire(const std::size_t file){
+  if(file>=files_.size()) return "";
+  pthread_mutex_lock(&mutex_);
+  if(file>=current_){
+    //Moves the look-ahead window; copies of files already read are removed
+    current_=file;
+    for(std::size_t earlier(0); earlier<file; ++earlier){
+      Delete(files_.at(earlier));
+    }
+    pthread_cond_broadcast(&changed_);
+  }
+  StagedFile& staged(files_.at(file));
+  while(staged.state==kCopying) pthread_cond_wait(&changed_, &mutex_);
+  if(staged.state==kPending){
+    staged.state=kDirect;
+    ++num_direct_;
+  }
+  const std::string name(staged.state==kStaged?staged.local_name:staged.name);
+  pthread_mutex_unlock(&mutex_);
+  return name;
+}
+
+std::size_t FileStager::GetNumFiles() const{
+  return files_.size();
+}
+
+std::size_t FileStager::GetNumStaged() const{
+  pthread_mutex_lock(&mutex_);
+  const std::size_t num_staged(num_staged_);
+  pthread_mutex_unlock(&mutex_);
+  return num_staged;
+}
+
+std::size_t FileStager::GetNumDirect() const{
+  pthread_mutex_lock(&mutex_);
+  const std::size_t num_direct(num_direct_);
+  pthread_mutex_unlock(&mutex_);
+  return num_direct;
+}
+
+void* FileStager::Run(void* stager){
+  static_cast<FileStager*>(stager)->Work();
+  return NULL;
+}
+
+void FileStager::Work(){
+  //Copies the pending files of the window [current_, current_+look_ahead_] in
+  //order. A file that does not fit waits until earlier copies are deleted, and
+  //is read directly if reading gets to it first.
+  pthread_mutex_lock(&mutex_);
+  while(!stop_){
+    StagedFile* next(NULL);
+    for(std::size_t file(current_); file<files_.size() && file<=current_+look_ahead_; ++file){
+      if(files_.at(file).state==kPending){
+        if(Fits(files_.at(file))) next=&files_.at(file);
+        break;
+      }
+    }
+    if(next==NULL){
+      pthread_cond_wait(&changed_, &mutex_);
+      continue;
+    }
+    next->state=kCopying;
+    used_bytes_+=next->size;
+    pthread_mutex_unlock(&mutex_);
+    const bool copied(Copy(*next));
+    pthread_mutex_lock(&mutex_);
+    if(copied){
+      next->state=kStaged;
+      ++num_staged_;
+      if(next<&files_.at(current_)) Delete(*next);
+    }else{
+      unlink(next->local_name.c_str());
+      used_bytes_-=next->size;
+      next->state=kFailed;
+    }
+    pthread_cond_broadcast(&changed_);
+  }
+  pthread_mutex_unlock(&mutex_);
+}
+
+bool FileStager::Fits(const StagedFile& file) const{
+  if(used_bytes_+file.size>budget_bytes_) return false;
+  struct statvfs disk;
+  if(statvfs(scratch_dir_.c_str(), &disk)!=0) return false;
+  const uint64_t available(static_cast<uint64_t>(disk.f_bavail)*disk.f_frsize);
+  return available>=file.size+scratch_reserve_bytes;
+}
+
+bool FileStager::Copy(const StagedFile& file) const{
+  //Runs without the lock; only checks stop_ between chunks
+  const int in(open(file.name.c_str(), O_RDONLY));
+  if(in<0) return false;
+  const int out(open(file.local_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+  if(out<0){
+    close(in);
+    return false;
+  }
+  std::vector<char> buffer(copy_chunk_size);
+  bool good(true), stopping(false);
+  while(good && !stopping){
+    const ssize_t num_read(read(in, &buffer.at(0), buffer.size()));
+    if(num_read==0) break;
+    if(num_read<0){
+      good=false;
+      break;
+    }
+    ssize_t num_written(0);
+    while(good && num_written<num_read){
+      const ssize_t written(write(out, &buffer.at(num_written), num_read-num_written));
+      if(written<=0) good=false;
+      else num_written+=written;
+    }
+    pthread_mutex_lock(&mutex_);
+    stopping=stop_;
+    pthread_mutex_unlock(&mutex_);
+  }
+  close(in);
+  if(close(out)!=0) good=false;
+  return good && !stopping;
+}
+
+void FileStager::Delete(StagedFile& file){
+  //Called with the lock held, or after the thread has stopped
+  if(file.state!=kStaged) return;
+  unlink(file.local_name.c_str());
+  used_bytes_-=file.size;
+  file.state=kDeleted;
+}
@@ -1,9 +1,12 @@
 /*
-  Takes a root file with directory configurableAnalysis containing trees eventA and eventB (as in cfA ntuple files) and produces source code for a container class containing all the branches.
+  Takes a root file with directory configurableAnalysis containing trees eventA and eventB (as in cfA ntuple files) and produces source code for a container class containing the branches. Strings and vectors are owned by the class and handed to ROOT, so ROOT does not allocate them. When branches are selected with -w or -s, only those branches get members and all other branches are disabled when reading.
 
-  Input: Exactly one .root file formatted as above. Only first command line argument accepted.
-  Output: a .cpp and a .hpp file containing source code for cfA container class
-  Options: None
+  Input: Exactly one .root file formatted as above.
+  Output: a .cpp and a .hpp file containing source code for cfA container class. Files whose contents would not change are not rewritten.
+  Options:
+  -w: File listing the branches to keep, separated by whitespace (# starts a comment)
+  -s: Source file. Every branch whose name appears in it is kept. May be given several times.
+  Without -w or -s, all branches are kept.
 */
 
 #include "generate_cfa_class.hpp"
@@ -11,22 +14,51 @@
 #include <sstream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <set>
+#include <unistd.h>
 #include "TFile.h"
 #include "TTree.h"
 #include "TChain.h"
 #include "TLeafObject.h"
 
 int main(int argc, char *argv[]){
-  if(argc>1){
-    TFile inFile(argv[1],"read");
+  std::set<std::string> selected;
+  bool selectAll(true);
+  int opt(0);
+  while((opt=getopt(argc, argv, "w:s:"))!=-1){
+    switch(opt){
+    case 'w':
+      AddWords(optarg, true, selected);
+      selectAll=false;
+      break;
+    case 's':
+      AddWords(optarg, false, selected);
+      selectAll=false;
+      break;
+    default:
+      break;
+    }
+  }
+
+  if(optind<argc){
+    TFile inFile(argv[optind],"read");
     if(inFile.IsOpen() && !inFile.IsZombie()){
-      std::ofstream cppFile("src/cfa.cpp"), hppFile("inc/cfa.hpp");
+      std::ostringstream cppFile(""), hppFile("");
 
       {TTree t("a","b");}//Magically make ROOT link things correctly...
 
       TChain *chainA(static_cast<TChain*>(inFile.Get("configurableAnalysis/eventA"))), *chainB(static_cast<TChain*>(inFile.Get("configurableAnalysis/eventB")));
 
       if(chainA!=NULL && chainB!=NULL){
+        const std::vector<Leaf> leavesA(GetLeaves(chainA, selected, selectAll));
+        const std::vector<Leaf> leavesB(GetLeaves(chainB, selected, selectAll));
+        if(!selectAll){
+          std::cout << "Keeping " << leavesA.size()+leavesB.size() << " of "
+                    << chainA->GetListOfLeaves()->GetSize()+chainB->GetListOfLeaves()->GetSize()
+                    << " branches." << std::endl;
+        }
+
         hppFile << "#ifndef H_CFA\n";
         hppFile << "#define H_CFA\n\n";
         hppFile << "#include <vector>\n";
@@ -34,32 +66,45 @@ int main(int argc, char *argv[]){
         hppFile << "#include \"TChain.h\"\n";
         hppFile << "#include \"TBranch.h\"\n\n";
 
+        hppFile << "class CfaBranchVisitor;\n";
+        hppFile << "class CfaCacheReader;\n\n";
+
         hppFile << "class cfA{\n";
+        hppFile << "public:\n";
+        hppFile << "  static bool IsUsableCache(const std::string&);\n\n";
         hppFile << "protected:\n";
         hppFile << "  cfA(const std::string&, const bool);\n";
+        hppFile << "  //Opens no input, for events filled in by hand\n";
+        hppFile << "  explicit cfA(const std::string&);\n";
+        hppFile << "  ~cfA();\n";
         hppFile << "  TChain chainA, chainB;\n";
         hppFile << "  TChain* GetChainA();\n";
         hppFile << "  TChain* GetChainB();\n";
         hppFile << "  std::string GetSampleName() const;\n";
         hppFile << "  int GetTotalEntries() const;\n";
         hppFile << "  int GetEntry(const unsigned int);\n";
-        hppFile << "  void SetFile(const std::string&, const bool);\n\n";
+        hppFile << "  void SetFile(const std::string&, const bool);\n";
+        hppFile << "  void VisitBranches(CfaBranchVisitor&);\n\n";
 
         hppFile << "  std::string sampleName;\n";
         hppFile << "  int totalEntries;\n";
-        hppFile << "  short cfAVersion;\n\n";
+        hppFile << "  short cfAVersion;\n";
+        hppFile << "  CfaCacheReader *cfACache;\n\n";
         hppFile << "  void GetVersion();\n";
         hppFile << "  void AddFiles(const std::string&, const bool);\n";
+        hppFile << "  void OpenCache(const std::string&);\n";
         hppFile << "  void CalcTotalEntries();\n";
         hppFile << "  void PrepareNewChains();\n";
         hppFile << "  void InitializeA();\n";
         hppFile << "  void InitializeB();\n\n";
     
-        PrintLeaves(chainA, hppFile);
-        PrintBranches(chainA, hppFile);
-        PrintLeaves(chainB, hppFile);
-        PrintBranches(chainB, hppFile);
-    
+        PrintLeaves(leavesA, hppFile);
+        PrintBranches(leavesA, hppFile);
+        PrintLeaves(leavesB, hppFile);
+        PrintBranches(leavesB, hppFile);
+        PrintStorage(leavesA, hppFile);
+        PrintStorage(leavesB, hppFile);
+
         hppFile << "};\n\n";
         hppFile << "#endif" << std::endl;
     
@@ -68,23 +113,75 @@ int main(int argc, char *argv[]){
         cppFile << "#include <string>\n";
         cppFile << "#include <fstream>\n";
         cppFile << "#include <sstream>\n";
+        cppFile << "#include <iostream>\n";
         cppFile << "#include \"TChain.h\"\n";
-        cppFile << "#include \"TBranch.h\"\n\n";
+        cppFile << "#include \"TBranch.h\"\n";
+        cppFile << "#include \"cfa_branch_visitor.hpp\"\n";
+        cppFile << "#include \"cfa_cache.hpp\"\n";
+        cppFile << "#include \"file_manifest.hpp\"\n\n";
+        //Shared by both constructors; only the initial sampleName differs
+        std::ostringstream initList("");
+        initList << "  totalEntries(0),\n";
+        initList << "  cfAVersion(-1),\n";
+        initList << "  cfACache(NULL)";
+        PrintNullInit(leavesA, initList);
+        PrintBranchInit(leavesA, initList);
+        PrintNullInit(leavesB, initList);
+        PrintBranchInit(leavesB, initList);
+
         cppFile << "cfA::cfA(const std::string& fileIn, const bool isList):\n";
         cppFile << "  chainA(\"eventA\"),\n";
         cppFile << "  chainB(\"eventB\"),\n";
         cppFile << "  sampleName(fileIn),\n";
-        cppFile << "  totalEntries(0),\n";
-        cppFile << "  cfAVersion(-1),\n";
-        PrintNullInit(chainA, cppFile);
-        PrintBranchInit(chainA, cppFile);
-        cppFile << ",\n";
-        PrintNullInit(chainB, cppFile);
-        PrintBranchInit(chainB, cppFile);
+        cppFile << initList.str();
         cppFile << "{\n";
+        cppFile << "  if(IsCfaCacheFile(fileIn)){\n";
+        cppFile << "    OpenCache(fileIn);\n";
+        cppFile << "    if(cfACache->IsOpen() && !cfACache->IsComplete()){\n";
+        cppFile << "      const std::vector<std::string>& missing(cfACache->GetMissingBranches());\n";
+        cppFile << "      std::cerr << \"Error: cfA cache \" << fileIn << \" does not match this cfA class (\"\n";
+        cppFile << "                << missing.size() << \" branches missing or of the wrong type, e.g. \" << missing.at(0)\n";
+        cppFile << "                << \"); no entries will be read. Remake it with make_cfa_cache.exe.\" << std::endl;\n";
+        cppFile << "    }\n";
+        cppFile << "  }else{\n";
+        cppFile << "    GetVersion();\n";
+        cppFile << "    AddFiles(fileIn, isList);\n";
+        cppFile << "    PrepareNewChains();\n";
+        cppFile << "  }\n";
+        cppFile << "}\n\n";
+
+        cppFile << "cfA::cfA(const std::string& sampleNameIn):\n";
+        cppFile << "  chainA(\"eventA\"),\n";
+        cppFile << "  chainB(\"eventB\"),\n";
+        cppFile << "  sampleName(sampleNameIn),\n";
+        cppFile << initList.str();
+        cppFile << "{\n";
+        cppFile << "  //Opens no input; the members keep whatever the caller puts in them\n";
         cppFile << "  GetVersion();\n";
-        cppFile << "  AddFiles(fileIn, isList);\n";
-        cppFile << "  PrepareNewChains();\n";
+        cppFile << "}\n\n";
+
+        cppFile << "cfA::~cfA(){\n";
+        cppFile << "  delete cfACache;\n";
+        cppFile << "}\n\n";
+
+        cppFile << "void cfA::OpenCache(const std::string& fileIn){\n";
+        cppFile << "  cfACache=new CfaCacheReader(fileIn);\n";
+        cppFile << "  if(cfACache->IsOpen()){\n";
+        cppFile << "    sampleName=cfACache->GetSampleName();\n";
+        cppFile << "    VisitBranches(*cfACache);\n";
+        cppFile << "  }\n";
+        cppFile << "  GetVersion();\n";
+        cppFile << "  totalEntries=cfACache->GetNumEntries();\n";
+        cppFile << "  //Reading on would give 0 for the missing branches in every event\n";
+        cppFile << "  if(cfACache->IsOpen() && !cfACache->IsComplete()) totalEntries=0;\n";
+        cppFile << "}\n\n";
+
+        cppFile << "bool cfA::IsUsableCache(const std::string& fileIn){\n";
+        cppFile << "  //Binds a throwaway object to the cache, which only maps the file\n";
+        cppFile << "  if(!IsCfaCacheFile(fileIn)) return false;\n";
+        cppFile << "  cfA probe(fileIn);\n";
+        cppFile << "  probe.OpenCache(fileIn);\n";
+        cppFile << "  return probe.cfACache!=NULL && probe.cfACache->IsComplete();\n";
         cppFile << "}\n\n";
 
         cppFile << "void cfA::GetVersion(){\n";
@@ -105,26 +202,37 @@ int main(int argc, char *argv[]){
         cppFile << "}\n\n";
 
         cppFile << "void cfA::AddFiles(const std::string& fileIn, const bool isList){\n";
-        cppFile << "  if(isList){\n";
-        cppFile << "    std::ifstream infile(fileIn.c_str());\n";
-        cppFile << "    std::string file(\"\");\n";
-        cppFile << "    while(infile >> file){\n";
-        cppFile << "      chainA.Add((file+\"/configurableAnalysis/eventA\").c_str());\n";
-        cppFile << "      chainB.Add((file+\"/configurableAnalysis/eventB\").c_str());\n";
+        cppFile << "  //Files whose entry counts are in the manifest are chained without being\n";
+        cppFile << "  //opened; the others are opened once here and added to the manifest\n";
+        cppFile << "  FileManifest manifest(fileIn, isList);\n";
+        cppFile << "  for(std::size_t file(0); file<manifest.GetNumFiles(); ++file){\n";
+        cppFile << "    const std::string& name(manifest.GetFileName(file));\n";
+        cppFile << "    if(manifest.IsKnown(file)){\n";
+        cppFile << "      //Passing 0 entries would make ROOT open the file again to count them,\n";
+        cppFile << "      //so known empty files are left out, as TChain leaves out empty trees\n";
+        cppFile << "      if(manifest.GetEntriesA(file)==0 && manifest.GetEntriesB(file)==0) continue;\n";
+        cppFile << "      chainA.Add((name+\"/configurableAnalysis/eventA\").c_str(), static_cast<Long64_t>(manifest.GetEntriesA(file)));\n";
+        cppFile << "      chainB.Add((name+\"/configurableAnalysis/eventB\").c_str(), static_cast<Long64_t>(manifest.GetEntriesB(file)));\n";
+        cppFile << "    }else{\n";
+        cppFile << "      const Long64_t entriesA(chainA.GetEntries()), entriesB(chainB.GetEntries());\n";
+        cppFile << "      const int addedA(chainA.Add((name+\"/configurableAnalysis/eventA\").c_str(), 0));\n";
+        cppFile << "      const int addedB(chainB.Add((name+\"/configurableAnalysis/eventB\").c_str(), 0));\n";
+        cppFile << "      if(addedA==1 && addedB==1){\n";
+        cppFile << "        manifest.SetEntries(file, chainA.GetEntries()-entriesA, chainB.GetEntries()-entriesB);\n";
+        cppFile << "      }\n";
         cppFile << "    }\n";
-        cppFile << "    infile.close();\n";
-        cppFile << "  }else{\n";
-        cppFile << "    chainA.Add((fileIn+\"/configurableAnalysis/eventA\").c_str());\n";
-        cppFile << "    chainB.Add((fileIn+\"/configurableAnalysis/eventB\").c_str());\n";
         cppFile << "  }\n";
+        cppFile << "  manifest.Save();\n";
         cppFile << "}\n\n";
 
         cppFile << "void cfA::SetFile(const std::string& fileIn, const bool isList){\n";
         cppFile << "  chainA.Reset(); chainB.Reset();\n";
         cppFile << "  AddFiles(fileIn, isList);\n";
+        cppFile << "  PrepareNewChains();\n";
         cppFile << "}\n\n";
 
         cppFile << "int cfA::GetEntry(const unsigned int entryIn){\n";
+        cppFile << "  if(cfACache!=NULL) return cfACache->GetEntry(entryIn);\n";
         cppFile << "  return chainA.GetEntry(entryIn)+chainB.GetEntry(entryIn);\n";
         cppFile << "}\n\n";
 
@@ -154,94 +262,161 @@ int main(int argc, char *argv[]){
         cppFile << "}\n\n";
 
         cppFile << "void cfA::InitializeA(){\n";
-        PrintSetNull(chainA, cppFile);
-        PrintSetBranchAddressA(chainA, cppFile);
+        PrintSetNull(leavesA, cppFile);
+        if(!selectAll) PrintSetBranchStatus("chainA", leavesA, cppFile);
+        PrintSetBranchAddress("chainA", leavesA, cppFile);
         cppFile << "}\n\n";
 
         cppFile << "void cfA::InitializeB(){\n";
-        PrintSetNull(chainB, cppFile);
-        PrintSetBranchAddressB(chainB, cppFile);
+        PrintSetNull(leavesB, cppFile);
+        if(!selectAll) PrintSetBranchStatus("chainB", leavesB, cppFile);
+        PrintSetBranchAddress("chainB", leavesB, cppFile);
+        cppFile << "}\n\n";
+
+        cppFile << "void cfA::VisitBranches(CfaBranchVisitor& visitor){\n";
+        PrintVisitBranches(leavesA, cppFile);
+        PrintVisitBranches(leavesB, cppFile);
         cppFile << "}\n\n";
       }else{
         std::cout << "Warning in " << argv[0] << ": one or both of chainA and chainB are NULL (" << chainA << " and " << chainB << ").\n";
       }
 
       inFile.Close();
-      cppFile.close();
-      hppFile.close();
+      WriteIfChanged("src/cfa.cpp", cppFile.str());
+      WriteIfChanged("inc/cfa.hpp", hppFile.str());
+    }else{
+      std::cout << "Warning in " << argv[0] << ": Could not open " << argv[optind] << ".\n";
+    }
+  }
+}
+
+void AddWords(const std::string& fileName, const bool isList, std::set<std::string>& words){
+  //Branch lists are whitespace separated names; source files contribute every identifier
+  std::ifstream inFile(fileName.c_str());
+  if(!inFile.is_open()){
+    std::cout << "Warning: Could not open " << fileName << ".\n";
+    return;
+  }
+  std::string line(""), word("");
+  while(std::getline(inFile, line)){
+    if(isList){
+      std::istringstream iss(line.substr(0, line.find('#')));
+      while(iss >> word) words.insert(word);
     }else{
-      std::cout << "Warning in " << argv[0] << ": Could not open " << argv[1] << ".\n";
+      word="";
+      for(std::string::size_type i(0); i<=line.size(); ++i){
+        const char c(i<line.size()?line.at(i):' ');
+        if(c=='_' || (c>='a' && c<='z') || (c>='A' && c<='Z') || (c>='0' && c<='9')){
+          word+=c;
+        }else if(word!=""){
+          words.insert(word);
+          word="";
+        }
+      }
     }
   }
 }
 
-void PrintLeaves(TChain *theChain, std::ofstream &theFile){
+std::vector<Leaf> GetLeaves(TChain *theChain, const std::set<std::string>& selected, const bool selectAll){
+  std::vector<Leaf> leaves(0);
   for(int i(0); i<theChain->GetListOfLeaves()->GetSize(); ++i){
-    std::string typeName(static_cast<TLeafObject*>((theChain->GetListOfLeaves()->At(i)))->GetTypeName());
-    std::string varName(static_cast<TLeaf*>((theChain->GetListOfLeaves()->At(i)))->GetBranch()->GetName());
-    bool nonSimp(false);
-    for(unsigned long j(typeName.find("vector")); j!=std::string::npos; j=typeName.find("vector",j+6)){
-      typeName.replace(j,6,"std::vector");
-      nonSimp=true;
+    Leaf leaf;
+    leaf.name=static_cast<TLeaf*>(theChain->GetListOfLeaves()->At(i))->GetBranch()->GetName();
+    if(!selectAll && selected.find(leaf.name)==selected.end()) continue;
+    leaf.type=static_cast<TLeafObject*>(theChain->GetListOfLeaves()->At(i))->GetTypeName();
+    leaf.isObject=false;
+    for(unsigned long j(leaf.type.find("vector")); j!=std::string::npos; j=leaf.type.find("vector",j+11)){
+      leaf.type.replace(j,6,"std::vector");
+      leaf.isObject=true;
     }
-    for(unsigned long j(typeName.find("string")); j!=std::string::npos; j=typeName.find("string",j+6)){
-      typeName.replace(j,6,"std::string");
-      nonSimp=true;
+    for(unsigned long j(leaf.type.find("string")); j!=std::string::npos; j=leaf.type.find("string",j+11)){
+      leaf.type.replace(j,6,"std::string");
+      leaf.isObject=true;
     }
-    if(nonSimp){
-      theFile << "  " << typeName << " *" << varName << ";\n";
+    leaves.push_back(leaf);
+  }
+  return leaves;
+}
+
+void WriteIfChanged(const std::string& fileName, const std::string& contents){
+  //Leaves the timestamp alone so that unchanged output does not trigger a rebuild
+  std::ifstream oldFile(fileName.c_str());
+  if(oldFile.is_open()){
+    std::ostringstream oldContents("");
+    oldContents << oldFile.rdbuf();
+    if(oldContents.str()==contents) return;
+    oldFile.close();
+  }
+  std::ofstream newFile(fileName.c_str());
+  newFile << contents;
+}
+
+void PrintLeaves(const std::vector<Leaf>& leaves, std::ostream &theFile){
+  for(std::size_t i(0); i<leaves.size(); ++i){
+    if(leaves.at(i).isObject){
+      theFile << "  " << leaves.at(i).type << " *" << leaves.at(i).name << ";\n";
     }else{
-      theFile << "  " << typeName << " " << varName << ";\n";
+      theFile << "  " << leaves.at(i).type << " " << leaves.at(i).name << ";\n";
     }
   }
 }
 
-void PrintBranches(TChain *theChain, std::ofstream &theFile){
-  for(int i(0); i<theChain->GetListOfLeaves()->GetSize(); ++i){
-    theFile << "  TBranch *b_" << static_cast<TLeaf*>(theChain->GetListOfLeaves()->At(i))->GetBranch()->GetName() << ";\n";
+void PrintBranches(const std::vector<Leaf>& leaves, std::ostream &theFile){
+  for(std::size_t i(0); i<leaves.size(); ++i){
+    theFile << "  TBranch *b_" << leaves.at(i).name << ";\n";
   }
 }
 
-void PrintNullInit(TChain *theChain, std::ofstream &theFile){
-  for(int i(0); i<theChain->GetListOfLeaves()->GetSize(); ++i){
-    const std::string typeName(static_cast<TLeafObject*>(theChain->GetListOfLeaves()->At(i))->GetTypeName());
-    if(typeName.find("string")==std::string::npos){
-      theFile << "  " << static_cast<TLeaf*>(theChain->GetListOfLeaves()->At(i))->GetBranch()->GetName() << "(0),\n";
+void PrintStorage(const std::vector<Leaf>& leaves, std::ostream &theFile){
+  for(std::size_t i(0); i<leaves.size(); ++i){
+    if(leaves.at(i).isObject){
+      theFile << "  " << leaves.at(i).type << " v_" << leaves.at(i).name << ";\n";
+    }
+  }
+}
+
+void PrintNullInit(const std::vector<Leaf>& leaves, std::ostream &theFile){
+  for(std::size_t i(0); i<leaves.size(); ++i){
+    if(leaves.at(i).isObject){
+      theFile << ",\n  " << leaves.at(i).name << "(&v_" << leaves.at(i).name << ")";
     }else{
-      theFile << "  " << static_cast<TLeaf*>(theChain->GetListOfLeaves()->At(i))->GetBranch()->GetName() << "(0),\n";
+      theFile << ",\n  " << leaves.at(i).name << "(0)";
     }
-  }  
+  }
 }
 
-void PrintSetNull(TChain *theChain, std::ofstream &theFile){
-  for(int i(0); i<theChain->GetListOfLeaves()->GetSize(); ++i){
-    const std::string typeName(static_cast<TLeafObject*>(theChain->GetListOfLeaves()->At(i))->GetTypeName());
-    if(true || typeName.find("string")!=std::string::npos || typeName.find("vector")!=std::string::npos){
-      theFile << "  " << static_cast<TLeaf*>(theChain->GetListOfLeaves()->At(i))->GetBranch()->GetName() << "=0;\n";
+void PrintSetNull(const std::vector<Leaf>& leaves, std::ostream &theFile){
+  for(std::size_t i(0); i<leaves.size(); ++i){
+    if(leaves.at(i).isObject){
+      theFile << "  " << leaves.at(i).name << "=&v_" << leaves.at(i).name << ";\n";
+    }else{
+      theFile << "  " << leaves.at(i).name << "=0;\n";
     }
   }
 }
 
-void PrintBranchInit(TChain *theChain, std::ofstream &theFile){
-  const int theSize(theChain->GetListOfLeaves()->GetSize());
-  for(int i(0); i<theSize-1; ++i){
-    theFile << "  b_" << static_cast<TLeaf*>(theChain->GetListOfLeaves()->At(i))->GetBranch()->GetName() << "(),\n";
+void PrintBranchInit(const std::vector<Leaf>& leaves, std::ostream &theFile){
+  for(std::size_t i(0); i<leaves.size(); ++i){
+    theFile << ",\n  b_" << leaves.at(i).name << "()";
   }
-  if(theChain->GetListOfLeaves()->GetSize()!=0){
-    theFile << "  b_" << static_cast<TLeaf*>(theChain->GetListOfLeaves()->At(theSize-1))->GetBranch()->GetName() << "()";
+}
+
+void PrintSetBranchStatus(const std::string& chainName, const std::vector<Leaf>& leaves, std::ostream &theFile){
+  theFile << "  " << chainName << ".SetBranchStatus(\"*\",0);\n";
+  for(std::size_t i(0); i<leaves.size(); ++i){
+    theFile << "  " << chainName << ".SetBranchStatus(\"" << leaves.at(i).name << "\",1);\n";
   }
 }
 
-void PrintSetBranchAddressA(TChain *theChain, std::ofstream &theFile){
-  for(int i(0); i<theChain->GetListOfLeaves()->GetSize(); ++i){
-    const std::string name(static_cast<TLeaf*>(theChain->GetListOfLeaves()->At(i))->GetBranch()->GetName());
-    theFile << "  chainA.SetBranchAddress(\"" << name << "\", &" << name << ", &b_" << name << ");\n";
-  }  
+void PrintSetBranchAddress(const std::string& chainName, const std::vector<Leaf>& leaves, std::ostream &theFile){
+  for(std::size_t i(0); i<leaves.size(); ++i){
+    const std::string& name(leaves.at(i).name);
+    theFile << "  " << chainName << ".SetBranchAddress(\"" << name << "\", &" << name << ", &b_" << name << ");\n";
+  }
 }
 
-void PrintSetBranchAddressB(TChain *theChain, std::ofstream &theFile){
-  for(int i(0); i<theChain->GetListOfLeaves()->GetSize(); ++i){
-    const std::string name(static_cast<TLeaf*>(theChain->GetListOfLeaves()->At(i))->GetBranch()->GetName());
-    theFile << "  chainB.SetBranchAddress(\"" << name << "\", &" << name << ", &b_" << name << ");\n";
-  }  
+void PrintVisitBranches(const std::vector<Leaf>& leaves, std::ostream &theFile){
+  for(std::size_t i(0); i<leaves.size(); ++i){
+    theFile << "  visitor.Visit(\"" << leaves.at(i).name << "\", " << leaves.at(i).name << ");\n";
+  }
 }
@@ -13,6 +13,7 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include <algorithm>
 
 //using namespace std;
 std::vector< std::vector<int> > MakeVRunLumi(std::string input){
@@ -127,3 +128,48 @@ void CheckVRunLumi2(std::vector< std::vector<int> > VVRunLumi){
     std::cout<<std::endl;
   }
 }
+
+LumiMask::LumiMask(const std::vector<std::vector<int> >& VVRunLumi):
+  ranges_(0){
+  for(std::size_t i(0); i<VVRunLumi.size(); ++i){
+    for(std::size_t j(1); j+1<VVRunLumi.at(i).size(); j+=2){
+      Range range;
+      range.run=VVRunLumi.at(i).at(0);
+      range.first=VVRunLumi.at(i).at(j);
+      range.last=VVRunLumi.at(i).at(j+1);
+      if(range.last>=range.first) ranges_.push_back(range);
+    }
+  }
+  std::sort(ranges_.begin(), ranges_.end());
+  //Overlapping ranges are merged so the range before a lumi section is the only candidate
+  std::vector<Range> merged(0);
+  for(std::size_t i(0); i<ranges_.size(); ++i){
+    if(merged.size()>0 && merged.back().run==ranges_.at(i).run
+       && ranges_.at(i).first<=merged.back().last){
+      merged.back().last=std::max(merged.back().last, ranges_.at(i).last);
+    }else{
+      merged.push_back(ranges_.at(i));
+    }
+  }
+  ranges_.swap(merged);
+}
+
+bool LumiMask::Contains(const int run, const int lumiblock) const{
+  if(run<120000) return true;
+  Range key;
+  key.run=run;
+  key.first=lumiblock;
+  key.last=lumiblock;
+  std::vector<Range>::const_iterator it(std::upper_bound(ranges_.begin(), ranges_.end(), key));
+  if(it==ranges_.begin()) return false;
+  --it;
+  return it->run==run && lumiblock>=it->first && lumiblock<=it->last;
+}
+
+std::size_t LumiMask::GetNumRanges() const{
+  return ranges_.size();
+}
+
+bool LumiMask::Range::operator<(const Range& other) const{
+  return run<other.run || (run==other.run && first<other.first);
+}
@@ -0,0 +1,72 @@
+/*
+  Copies the cfA branches used by the analysis into a local, uncompressed columnar cache which EventHandler can read in place of the original ntuples.
+  Input: cfA format .root file (file path given with -i option)
+  Output: .cfacache file (file path may optionally be specified with -o option)
+  Options:
+  -i: Set input file name. Only one file path accepted, but may contain wildcards.
+  -c: Denotes that input name is only a cfA ntuple name and program should intelligently figure out the full path
+  -o: Explicitly set output file name (automatically determined if not set)
+  -b: Read the list of branches to keep (one per line) from the given file instead of using the branches EventHandler needs
+*/
+
+#include <iostream>
+#include <string>
+#include <set>
+#include <unistd.h>
+#include "cfa_cache_maker.hpp"
+
+int main(int argc, char *argv[]){
+  std::string inFilename("");
+  bool iscfA(false);
+  bool explicit_outfile(false);
+  std::string outFilename("");
+  std::string branchFilename("");
+
+  int c(0);
+  while((c=getopt(argc, argv, "i:o:cb:"))!=-1){
+    switch(c){
+    case 'i':
+      inFilename=optarg;
+      break;
+    case 'c':
+      iscfA=true;
+      break;
+    case 'o':
+      explicit_outfile=true;
+      outFilename=optarg;
+      break;
+    case 'b':
+      branchFilename=optarg;
+      break;
+    default:
+      break;
+    }
+  }
+
+  if(iscfA){
+    if(!explicit_outfile) outFilename="cfa_cache/"+inFilename+".cfacache";
+    inFilename="/net/cms2/cms2r0/cfA/"+inFilename+"/cfA_"+inFilename+"*.root";
+  }else{
+    std::string baseName(inFilename);
+    size_t pos(baseName.find(".root"));
+    if(pos!=std::string::npos){
+      baseName.erase(pos);
+    }
+    pos=baseName.rfind("/");
+    if(pos!=std::string::npos){
+      if(pos!=baseName.size()-1){
+        baseName.erase(0,pos+1);
+      }else{
+        baseName.append("file_name_ended_with_slash");
+      }
+    }
+    if(!explicit_outfile) outFilename="cfa_cache/"+baseName+".cfacache";
+    std::cout << inFilename << "\n" << baseName << "\n" << outFilename << "\n";
+  }
+
+  CfaCacheMaker ccm(inFilename, false);
+  const std::set<std::string> branches(branchFilename==""
+                                       ?ccm.GetDefaultBranches()
+                                       :CfaCacheMaker::ReadBranchList(branchFilename));
+  return ccm.MakeCache(outFilename, branches)?0:1;
+}
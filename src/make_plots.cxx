@@ -0,0 +1,361 @@
+/*
+  Makes stacked histograms of reduced_tree variables for several samples as described by a config file. Every input file is read once, no matter how many plots are requested, and files are processed in parallel.
+  Input: config file given with -f (see configs/example_plots.cfg for the format). The reduced_trees listed there are read through their columnar copies (see export_reduced_tree.exe), which are made automatically if missing or out of date.
+  Output: one image per plot in the output directory (plots by default)
+  Options:
+  -f: Config file name (default configs/example_plots.cfg)
+  -o: Output directory (overrides output_dir in the config file)
+  -j: Number of threads (default number of processors)
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <unistd.h>
+#include <glob.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include "TROOT.h"
+#include "TStyle.h"
+#include "TH1D.h"
+#include "THStack.h"
+#include "TLegend.h"
+#include "TCanvas.h"
+#include "reduced_tree_columns.hpp"
+#include "cut_expression.hpp"
+#include "weighted_histogram.hpp"
+#include "utils.hpp"
+
+namespace{
+  struct Sample{
+    std::string name, title, weight;
+    std::vector<std::string> files;
+  };
+
+  struct Plot{
+    std::string name, variable, cut, x_title;
+    unsigned num_bins;
+    double low, high;
+  };
+
+  struct Config{
+    std::string output_dir, weight, cut, format;
+    bool log_y;
+    std::vector<Sample> samples;
+    std::vector<Plot> plots;
+  };
+
+  //One histogram per plot for each file
+  struct FileResult{
+    std::vector<WeightedHistogram> histos;
+    bool good;
+  };
+
+  struct Job{
+    std::size_t sample;
+    std::string file;
+  };
+
+  struct WorkQueue{
+    const Config* config;
+    const std::vector<Job>* jobs;
+    std::vector<FileResult>* results;
+    std::size_t next_job;
+    pthread_mutex_t mutex;
+  };
+
+  std::vector<std::string> SplitFields(const std::string& line){
+    //Whitespace separated fields; double quotes group words, # starts a comment
+    std::vector<std::string> fields(0);
+    std::string field("");
+    bool in_quotes(false), have_field(false);
+    for(std::string::size_type i(0); i<line.size(); ++i){
+      const char c(line.at(i));
+      if(c=='"'){
+        in_quotes=!in_quotes;
+        have_field=true;
+      }else if(!in_quotes && c=='#'){
+        break;
+      }else if(!in_quotes && (c==' ' || c=='\t' || c=='\r')){
+        if(have_field) fields.push_back(field);
+        field="";
+        have_field=false;
+      }else{
+        field+=c;
+        have_field=true;
+      }
+    }
+    if(have_field) fields.push_back(field);
+    return fields;
+  }
+
+  std::vector<std::string> ExpandFiles(const std::string& pattern){
+    std::vector<std::string> files(0);
+    glob_t matches;
+    if(glob(pattern.c_str(), 0, NULL, &matches)==0){
+      for(std::size_t i(0); i<matches.gl_pathc; ++i){
+        files.push_back(matches.gl_pathv[i]);
+      }
+    }
+    globfree(&matches);
+    if(files.size()==0){
+      std::cerr << "Warning: no files match " << pattern << '.' << std::endl;
+    }
+    return files;
+  }
+
+  bool ReadConfig(const std::string& file_name, Config& config){
+    std::ifstream file(file_name.c_str());
+    if(!file.is_open()){
+      std::cerr << "Error: Could not open config file " << file_name << '.' << std::endl;
+      return false;
+    }
+    config.output_dir="plots";
+    config.weight="full_weight";
+    config.cut="1";
+    config.format="pdf";
+    config.log_y=false;
+    std::string line("");
+    for(unsigned line_num(1); std::getline(file, line); ++line_num){
+      const std::vector<std::string> fields(SplitFields(line));
+      if(fields.size()==0) continue;
+      const std::string& key(fields.at(0));
+      if(key=="output_dir" && fields.size()==2){
+        config.output_dir=fields.at(1);
+      }else if(key=="weight" && fields.size()==2){
+        config.weight=fields.at(1);
+      }else if(key=="cut" && fields.size()==2){
+        config.cut=fields.at(1);
+      }else if(key=="format" && fields.size()==2){
+        config.format=fields.at(1);
+      }else if(key=="log_y" && fields.size()==2){
+        config.log_y=fields.at(1)=="true" || fields.at(1)=="1";
+      }else if(key=="sample" && fields.size()>=5){
+        Sample sample;
+        sample.name=fields.at(1);
+        sample.title=fields.at(2);
+        sample.weight=fields.at(3);
+        for(std::size_t i(4); i<fields.size(); ++i){
+          const std::vector<std::string> files(ExpandFiles(fields.at(i)));
+          sample.files.insert(sample.files.end(), files.begin(), files.end());
+        }
+        config.samples.push_back(sample);
+      }else if(key=="plot" && fields.size()>=6 && fields.size()<=8){
+        Plot plot;
+        plot.name=fields.at(1);
+        plot.variable=fields.at(2);
+        plot.num_bins=atoi(fields.at(3).c_str());
+        plot.low=atof(fields.at(4).c_str());
+        plot.high=atof(fields.at(5).c_str());
+        plot.cut=fields.size()>6?fields.at(6):"";
+        plot.x_title=fields.size()>7?fields.at(7):plot.variable;
+        if(plot.num_bins==0 || !(plot.high>plot.low)){
+          std::cerr << "Error: bad binning for plot " << plot.name << " on line "
+                    << line_num << " of " << file_name << '.' << std::endl;
+          return false;
+        }
+        config.plots.push_back(plot);
+      }else{
+        std::cerr << "Error: Could not parse line " << line_num << " of "
+                  << file_name << ": " << line << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::size_t AddExpression(std::vector<CutExpression>& expressions,
+                            std::map<std::string, std::size_t>& indices,
+                            const std::string& expression){
+    const std::string key(expression==""?"1":expression);
+    const std::map<std::string, std::size_t>::const_iterator it(indices.find(key));
+    if(it!=indices.end()) return it->second;
+    expressions.push_back(CutExpression(key));
+    indices[key]=expressions.size()-1;
+    return expressions.size()-1;
+  }
+
+  void FillFile(const Config& config, const Job& job, FileResult& result){
+    const std::vector<Plot>& plots(config.plots);
+    result.good=false;
+    result.histos.clear();
+    for(std::size_t plot(0); plot<plots.size(); ++plot){
+      result.histos.push_back(WeightedHistogram(plots.at(plot).num_bins,
+                                                plots.at(plot).low, plots.at(plot).high));
+    }
+
+    const ReducedTreeColumns columns(GetReducedTreeColumnsName(job.file));
+    if(!columns.IsOpen()) return;
+
+    //Expressions shared between plots are evaluated once per batch
+    std::vector<CutExpression> expressions;
+    std::map<std::string, std::size_t> indices;
+    const Sample& sample(config.samples.at(job.sample));
+    const std::size_t cut(AddExpression(expressions, indices, config.cut));
+    const std::size_t weight(AddExpression(expressions, indices, sample.weight==""?config.weight:sample.weight));
+    std::vector<std::size_t> variables(plots.size()), plot_cuts(plots.size());
+    for(std::size_t plot(0); plot<plots.size(); ++plot){
+      variables.at(plot)=AddExpression(expressions, indices, plots.at(plot).variable);
+      plot_cuts.at(plot)=AddExpression(expressions, indices, plots.at(plot).cut);
+    }
+    for(std::size_t i(0); i<expressions.size(); ++i){
+      if(!expressions.at(i).Bind(columns.GetFile())){
+        std::cerr << expressions.at(i).GetError() << " (" << job.file << ')' << std::endl;
+        return;
+      }
+    }
+
+    std::vector<const double*> values(expressions.size(), static_cast<const double*>(NULL));
+    std::vector<double> event_weights(CutExpression::batch_size, 0.0);
+    std::vector<double> plot_weights(CutExpression::batch_size, 0.0);
+    const uint64_t num_entries(columns.GetNumEntries());
+    for(uint64_t first(0); first<num_entries; first+=CutExpression::batch_size){
+      const std::size_t batch(num_entries-first<CutExpression::batch_size
+                              ?num_entries-first:CutExpression::batch_size);
+      for(std::size_t i(0); i<expressions.size(); ++i){
+        values.at(i)=expressions.at(i).Evaluate(first, batch);
+      }
+      for(std::size_t entry(0); entry<batch; ++entry){
+        event_weights.at(entry)=values.at(cut)[entry]*values.at(weight)[entry];
+      }
+      for(std::size_t plot(0); plot<plots.size(); ++plot){
+        const double* const plot_cut(values.at(plot_cuts.at(plot)));
+        for(std::size_t entry(0); entry<batch; ++entry){
+          plot_weights.at(entry)=event_weights.at(entry)*plot_cut[entry];
+        }
+        result.histos.at(plot).Fill(0, values.at(variables.at(plot)), &plot_weights.at(0), batch);
+      }
+    }
+    for(std::size_t plot(0); plot<plots.size(); ++plot){
+      result.histos.at(plot).Merge();
+    }
+    result.good=true;
+  }
+
+  void* RunWorker(void* arg){
+    WorkQueue& queue(*static_cast<WorkQueue*>(arg));
+    for(;;){
+      pthread_mutex_lock(&queue.mutex);
+      const std::size_t job(queue.next_job++);
+      pthread_mutex_unlock(&queue.mutex);
+      if(job>=queue.jobs->size()) break;
+      FillFile(*queue.config, queue.jobs->at(job), queue.results->at(job));
+    }
+    return NULL;
+  }
+}
+
+int main(int argc, char *argv[]){
+  std::string config_file_name("configs/example_plots.cfg"), output_dir("");
+  long num_threads(sysconf(_SC_NPROCESSORS_ONLN));
+
+  int c(0);
+  while((c=getopt(argc, argv, "f:o:j:"))!=-1){
+    switch(c){
+    case 'f':
+      config_file_name=optarg;
+      break;
+    case 'o':
+      output_dir=optarg;
+      break;
+    case 'j':
+      num_threads=atoi(optarg);
+      break;
+    default:
+      break;
+    }
+  }
+  if(num_threads<1) num_threads=1;
+
+  Config config;
+  if(!ReadConfig(config_file_name, config)) return 1;
+  if(output_dir!="") config.output_dir=output_dir;
+  //Made before any input is read so a bad output path fails right away
+  struct stat dir_stat;
+  if(mkdir(config.output_dir.c_str(), 0755)!=0
+     && (errno!=EEXIST || stat(config.output_dir.c_str(), &dir_stat)!=0 || !S_ISDIR(dir_stat.st_mode))){
+    std::cerr << "Error: Could not create output directory " << config.output_dir
+              << " (" << strerror(errno) << ")." << std::endl;
+    return 1;
+  }
+
+  //Columnar copies are made up front since ROOT I/O is not used from the worker threads
+  std::vector<Job> jobs(0);
+  for(std::size_t sample(0); sample<config.samples.size(); ++sample){
+    for(std::size_t file(0); file<config.samples.at(sample).files.size(); ++file){
+      Job job;
+      job.sample=sample;
+      job.file=config.samples.at(sample).files.at(file);
+      if(ReducedTreeColumnsAreOutOfDate(job.file)){
+        const std::string columns_name(GetReducedTreeColumnsName(job.file));
+        std::cout << "Exporting " << job.file << " to " << columns_name << std::endl;
+        if(!ExportReducedTree(job.file, columns_name)) return 1;
+      }
+      jobs.push_back(job);
+    }
+  }
+
+  std::vector<FileResult> results(jobs.size());
+  WorkQueue queue;
+  queue.config=&config;
+  queue.jobs=&jobs;
+  queue.results=&results;
+  queue.next_job=0;
+  pthread_mutex_init(&queue.mutex, NULL);
+  std::vector<pthread_t> threads(num_threads);
+  for(std::size_t thread(0); thread<threads.size(); ++thread){
+    pthread_create(&threads.at(thread), NULL, RunWorker, &queue);
+  }
+  for(std::size_t thread(0); thread<threads.size(); ++thread){
+    pthread_join(threads.at(thread), NULL);
+  }
+  pthread_mutex_destroy(&queue.mutex);
+
+  int status(0);
+  for(std::size_t job(0); job<jobs.size(); ++job){
+    if(!results.at(job).good){
+      std::cerr << "Error: Could not process " << jobs.at(job).file << '.' << std::endl;
+      status=1;
+    }
+  }
+
+  gStyle->SetOptStat(0);
+  for(std::size_t plot(0); plot<config.plots.size(); ++plot){
+    const Plot& binning(config.plots.at(plot));
+    std::vector<TH1D> histos(0);
+    for(std::size_t sample(0); sample<config.samples.size(); ++sample){
+      const std::string histo_name(binning.name+"_"+config.samples.at(sample).name);
+      //Merged in job order so the result does not depend on thread scheduling
+      WeightedHistogram total(binning.num_bins, binning.low, binning.high);
+      for(std::size_t job(0); job<jobs.size(); ++job){
+        if(jobs.at(job).sample!=sample || !results.at(job).good) continue;
+        total.Add(results.at(job).histos.at(plot));
+      }
+      histos.push_back(total.GetTH1D(histo_name, ";"+binning.x_title+";Events"));
+    }
+    assign_colors(histos);
+
+    THStack stack(binning.name.c_str(), (";"+binning.x_title+";Events").c_str());
+    TLegend legend(0.7, 0.7, 0.95, 0.95);
+    for(std::size_t sample(histos.size()); sample>0; --sample){
+      stack.Add(&histos.at(sample-1), "hist");
+    }
+    for(std::size_t sample(0); sample<histos.size(); ++sample){
+      legend.AddEntry(&histos.at(sample), config.samples.at(sample).title.c_str(), "f");
+    }
+
+    TCanvas canvas;
+    canvas.SetLogy(config.log_y);
+    stack.Draw();
+    legend.Draw();
+    canvas.Print((config.output_dir+"/"+binning.name+"."+config.format).c_str());
+  }
+
+  return status;
+}
@@ -4,13 +4,20 @@
   Output: reduced_tree format .root file (file path may optionally be specified with -o option)
   Options:
   -i: Set input file name. Only one file path accepted, but may contain wildcards.
-  -c: Denotes that input name is only a cfA ntuple name and program should intelligently figure out the full path
+  -c: Denotes that input name is only a cfA ntuple name and program should intelligently figure out the full path. Uses cfa_cache/<name>.cfacache instead of the ntuples if it exists and has every branch the analysis reads (see make_cfa_cache.exe)
   -o: Explicitly set output file name (automatically determined if not set)
+  -j: For Run2012 data, only keep events in certified lumi sections. The JSON mask is applied in a first pass over run and lumiblock, so rejected events are never fully read.
+  -n: For MC, normalize to the number of events in the input (per mass point for SMS scans) instead of the built-in table. The counts are made in a first pass and cached in cfa_cache/normalization_catalog.txt under the dataset name and its list of files. Requires -c, so that the input is the whole dataset; a job on part of a dataset would be normalized to that part only.
+  -p: For MC, reweight pileup against the sample's own true interaction distribution instead of Summer2012_S10. The distribution is made in a first pass over the pileup branches and cached in <output>_pu_profile.txt.
+  -s: Copy the input ntuples to the given local scratch directory a couple of files ahead of the event loop and read them from there. Copies are deleted once read; files that are not copied in time are read directly.
+  -b: Disk budget in GB for the staged copies (default 20)
 */
 
 #include <iostream>
 #include <string>
+#include <cstdlib>
 #include <unistd.h>
+#include <stdint.h>
 #include "reduced_tree_maker.hpp"
 #include "weights.hpp"
 
@@ -18,10 +25,15 @@ int main(int argc, char *argv[]){
   std::string inFilename("");
   bool iscfA(false);
   bool explicit_outfile(false);
+  bool certified_only(false);
+  bool sample_pileup_profile(false);
+  bool measured_normalization(false);
   std::string outFilename("");
+  std::string scratch_dir("");
+  double staging_budget(20.0);
 
   int c(0);
-  while((c=getopt(argc, argv, "i:o:c"))!=-1){
+  while((c=getopt(argc, argv, "i:o:s:b:cjnp"))!=-1){
     switch(c){
     case 'i':
       inFilename=optarg;
@@ -29,6 +41,21 @@ int main(int argc, char *argv[]){
     case 'c':
       iscfA=true;
       break;
+    case 'j':
+      certified_only=true;
+      break;
+    case 'n':
+      measured_normalization=true;
+      break;
+    case 'p':
+      sample_pileup_profile=true;
+      break;
+    case 's':
+      scratch_dir=optarg;
+      break;
+    case 'b':
+      staging_budget=atof(optarg);
+      break;
     case 'o':
       explicit_outfile=true;
       outFilename=optarg;
@@ -37,15 +64,31 @@ int main(int argc, char *argv[]){
     }
   }
   
+  if(measured_normalization && !iscfA){
+    std::cerr << "Error: -n counts the events of the input, so it needs the whole dataset (-c)." << std::endl;
+    return 1;
+  }
+
   if(iscfA){
     if(!explicit_outfile) outFilename="reduced_trees/"+inFilename+".root";
-    inFilename="/net/cms2/cms2r0/cfA/"+inFilename+"/cfA_"+inFilename+"*.root";
+    const std::string cacheFilename("cfa_cache/"+inFilename+".cfacache");
+    const bool have_cache(access(cacheFilename.c_str(), R_OK)==0);
+    if(have_cache && ReducedTreeMaker::IsUsableCache(cacheFilename)){
+      inFilename=cacheFilename;
+    }else{
+      if(have_cache) std::cerr << "Warning: " << cacheFilename << " is stale; reading the ntuples instead." << std::endl;
+      inFilename="/net/cms2/cms2r0/cfA/"+inFilename+"/cfA_"+inFilename+"*.root";
+    }
   }else{
     std::string baseName(inFilename);
     size_t pos(baseName.find(".root"));
     if(pos!=std::string::npos){
       baseName.erase(pos);
     }
+    pos=baseName.find(".cfacache");
+    if(pos!=std::string::npos){
+      baseName.erase(pos);
+    }
     pos=baseName.rfind("/");
     if(pos!=std::string::npos){
       if(pos!=baseName.size()-1){
@@ -60,5 +103,8 @@ int main(int argc, char *argv[]){
 
   WeightCalculator w(19399);
   ReducedTreeMaker rtm(inFilename, false, w.GetWeight(inFilename));
-  rtm.MakeReducedTree(outFilename);
+  if(scratch_dir!=""){
+    rtm.EnableStaging(scratch_dir, static_cast<uint64_t>(staging_budget*1.e9));
+  }
+  rtm.MakeReducedTree(outFilename, certified_only, sample_pileup_profile, measured_normalization);
 }
@@ -0,0 +1,116 @@
+#include "mc_truth_index.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+McTruthIndex::McTruthIndex():
+  ids_(0),
+  mother_ids_(0),
+  grandmother_ids_(0),
+  species_(kNumSpecies){
+}
+
+void McTruthIndex::Build(const std::vector<float>& ids,
+                         const std::vector<float>& mother_ids,
+                         const std::vector<float>& grandmother_ids){
+  //Containers keep their capacity, so building does not allocate once warmed up
+  const std::size_t num_particles(std::min(ids.size(), std::min(mother_ids.size(), grandmother_ids.size())));
+  ids_.resize(num_particles);
+  mother_ids_.resize(num_particles);
+  grandmother_ids_.resize(num_particles);
+  for(std::size_t species(0); species<species_.size(); ++species){
+    species_.at(species).clear();
+  }
+  for(std::size_t particle(0); particle<num_particles; ++particle){
+    const int id(ToPdgId(ids.at(particle)));
+    ids_.at(particle)=id;
+    mother_ids_.at(particle)=ToPdgId(mother_ids.at(particle));
+    grandmother_ids_.at(particle)=ToPdgId(grandmother_ids.at(particle));
+    switch(abs(id)){
+    case 11: species_.at(kElectrons).push_back(particle); break;
+    case 13: species_.at(kMuons).push_back(particle); break;
+    case 15: species_.at(kTaus).push_back(particle); break;
+    case 12: case 14: case 16: species_.at(kNeutrinos).push_back(particle); break;
+    case 6: species_.at(kTops).push_back(particle); break;
+    case 24: species_.at(kWs).push_back(particle); break;
+    case 5: species_.at(kBQuarks).push_back(particle); break;
+    default: break;
+    }
+  }
+}
+
+std::size_t McTruthIndex::GetNumParticles() const{
+  return ids_.size();
+}
+
+int McTruthIndex::GetId(const std::size_t particle) const{
+  return ids_.at(particle);
+}
+
+int McTruthIndex::GetMotherId(const std::size_t particle) const{
+  return mother_ids_.at(particle);
+}
+
+int McTruthIndex::GetGrandmotherId(const std::size_t particle) const{
+  return grandmother_ids_.at(particle);
+}
+
+const std::vector<unsigned>& McTruthIndex::GetParticles(const Species species) const{
+  return species_.at(species);
+}
+
+unsigned McTruthIndex::GetNumEMu(const bool check_W, const bool check_top) const{
+  unsigned count(0);
+  for(int species(kElectrons); species<=kMuons; ++species){
+    const std::vector<unsigned>& particles(species_.at(species));
+    for(std::size_t i(0); i<particles.size(); ++i){
+      if((!check_W || abs(mother_ids_.at(particles.at(i)))==24)
+         && (!check_top || abs(grandmother_ids_.at(particles.at(i)))==6)){
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+unsigned McTruthIndex::GetNumLeptonsFromTop() const{
+  //Charged leptons, taus included, from t->Wb->lnub
+  unsigned count(0);
+  for(int species(kElectrons); species<=kTaus; ++species){
+    const std::vector<unsigned>& particles(species_.at(species));
+    for(std::size_t i(0); i<particles.size(); ++i){
+      if(IsFromTop(mother_ids_.at(particles.at(i)), grandmother_ids_.at(particles.at(i)))) ++count;
+    }
+  }
+  return count;
+}
+
+McTruthIndex::TtbarDecay McTruthIndex::GetTtbarDecay() const{
+  bool found_top(false), found_antitop(false);
+  const std::vector<unsigned>& tops(species_.at(kTops));
+  for(std::size_t i(0); i<tops.size(); ++i){
+    if(ids_.at(tops.at(i))>0){
+      found_top=true;
+    }else{
+      found_antitop=true;
+    }
+  }
+  if(!found_top || !found_antitop) return kNotTtbar;
+  const unsigned num_leptons(GetNumLeptonsFromTop());
+  if(num_leptons==0){
+    return kFullyHadronic;
+  }else if(num_leptons==1){
+    return kSemileptonic;
+  }else{
+    return kDileptonic;
+  }
+}
+
+int McTruthIndex::ToPdgId(const float id){
+  return static_cast<int>(floor(id+0.5));
+}
+
+bool McTruthIndex::IsFromTop(const int mother_id, const int grandmother_id){
+  return abs(mother_id)==24 && abs(grandmother_id)==6;
+}
@@ -0,0 +1,130 @@
+#include "normalization_catalog.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "weights.hpp"
+#include "cache_io.hpp"
+
+namespace{
+  struct CatalogEntry{
+    std::string dataset;
+    uint64_t key;
+    GeneratedEventCounts counts;
+  };
+
+  std::vector<CatalogEntry> ReadEntries(const std::string& file_name){
+    //Each entry is "dataset key total num_mass_points" followed by one
+    //"mass1 mass2 count" line per mass point; reading stops at the first bad entry
+    std::vector<CatalogEntry> entries(0);
+    std::ifstream file(file_name.c_str());
+    CatalogEntry entry;
+    std::string key("");
+    std::size_t num_mass_points(0);
+    while(file >> entry.dataset >> key >> entry.counts.total >> num_mass_points){
+      std::istringstream key_stream(key);
+      key_stream >> std::hex >> entry.key;
+      if(key_stream.fail()) break;
+      entry.counts.mass_points.clear();
+      int mass1(0), mass2(0), count(0);
+      std::size_t point(0);
+      for(; point<num_mass_points && (file >> mass1 >> mass2 >> count); ++point){
+        entry.counts.mass_points[std::make_pair(mass1, mass2)]=count;
+      }
+      if(point<num_mass_points) break;
+      entries.push_back(entry);
+    }
+    return entries;
+  }
+}
+
+NormalizationCatalog::NormalizationCatalog(const std::string& file_name):
+  file_name_(file_name){
+}
+
+const std::string& NormalizationCatalog::GetFileName() const{
+  return file_name_;
+}
+
+bool NormalizationCatalog::Find(const std::string& dataset, const uint64_t key,
+                                GeneratedEventCounts& counts) const{
+  const std::vector<CatalogEntry> entries(ReadEntries(file_name_));
+  for(std::size_t entry(0); entry<entries.size(); ++entry){
+    if(entries.at(entry).dataset==dataset && entries.at(entry).key==key){
+      counts=entries.at(entry).counts;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool NormalizationCatalog::Store(const std::string& dataset, const uint64_t key,
+                                 const GeneratedEventCounts& counts) const{
+  //Replaces the dataset's entry. Jobs on other datasets may store at the same
+  //time, so the whole read-modify-write holds the catalog's lock.
+  if(dataset=="" || dataset.find_first_of(" \t\n")!=std::string::npos){
+    std::cerr << "Error: cannot catalog dataset name \"" << dataset << "\"." << std::endl;
+    return false;
+  }
+  const FileLock lock(file_name_+".lock");
+  if(!lock.IsLocked()){
+    std::cerr << "Warning: could not lock normalization catalog " << file_name_ << '.' << std::endl;
+    return false;
+  }
+  std::vector<CatalogEntry> entries(ReadEntries(file_name_));
+  CatalogEntry new_entry;
+  new_entry.dataset=dataset;
+  new_entry.key=key;
+  new_entry.counts=counts;
+  bool replaced(false);
+  for(std::size_t entry(0); entry<entries.size(); ++entry){
+    if(entries.at(entry).dataset==dataset){
+      entries.at(entry)=new_entry;
+      replaced=true;
+    }
+  }
+  if(!replaced) entries.push_back(new_entry);
+
+  AtomicFileWriter writer(file_name_);
+  std::ofstream& file(writer.GetStream());
+  for(std::size_t entry(0); entry<entries.size(); ++entry){
+    const CatalogEntry& this_entry(entries.at(entry));
+    std::ostringstream key_string("");
+    key_string << std::hex;
+    key_string.width(16);
+    key_string.fill('0');
+    key_string << this_entry.key;
+    file << this_entry.dataset << ' ' << key_string.str() << ' ' << this_entry.counts.total
+         << ' ' << this_entry.counts.mass_points.size() << '\n';
+    for(std::map<std::pair<int, int>, int>::const_iterator point(this_entry.counts.mass_points.begin());
+        point!=this_entry.counts.mass_points.end(); ++point){
+      file << point->first.first << ' ' << point->first.second << ' ' << point->second << '\n';
+    }
+  }
+  if(!writer.Commit()){
+    std::cerr << "Warning: could not write normalization catalog " << file_name_ << '.' << std::endl;
+    return false;
+  }
+  return true;
+}
+
+uint64_t NormalizationCatalog::GetKey(const std::vector<std::string>& files){
+  CacheHash hash;
+  for(std::size_t file(0); file<files.size(); ++file){
+    hash.Add(files.at(file));
+    hash.AddByte(0xff);
+    struct stat file_stat;
+    if(stat(files.at(file).c_str(), &file_stat)==0){
+      const int64_t size(file_stat.st_size), mtime(file_stat.st_mtime);
+      hash.Add(&size, sizeof(size));
+      hash.Add(&mtime, sizeof(mtime));
+    }
+  }
+  return hash.Get();
+}
@@ -0,0 +1,70 @@
+#include "pileup_weights.hpp"
+#include <vector>
+#include <string>
+#include <iostream>
+
+namespace{
+  std::vector<float> Normalize(const std::vector<float>& profile){
+    //Float storage of a TH1F, scaled by the inverse of its double integral
+    double integral(0.0);
+    for(std::size_t bin(0); bin<profile.size(); ++bin){
+      integral+=profile.at(bin);
+    }
+    const double scale(1.0/integral);
+    std::vector<float> normalized(profile.size());
+    for(std::size_t bin(0); bin<profile.size(); ++bin){
+      normalized.at(bin)=scale*profile.at(bin);
+    }
+    return normalized;
+  }
+}
+
+PileupWeights::PileupWeights(const std::vector<float>& mc_profile):
+  num_bins_(mc_profile.size()),
+  mc_profile_(Normalize(mc_profile)),
+  names_(0),
+  table_(0){
+}
+
+bool PileupWeights::AddScenario(const std::string& name, const std::vector<float>& data_profile){
+  if(data_profile.size()!=num_bins_){
+    std::cerr << "Error: pileup scenario " << name << " has " << data_profile.size()
+              << " bins instead of " << num_bins_ << '.' << std::endl;
+    return false;
+  }
+  const std::vector<float> data(Normalize(data_profile));
+  const std::size_t old_scenarios(names_.size());
+  std::vector<float> table((num_bins_+2)*(old_scenarios+1), 0.0);
+  for(std::size_t bin(0); bin<num_bins_+2; ++bin){
+    for(std::size_t scenario(0); scenario<old_scenarios; ++scenario){
+      table.at(bin*(old_scenarios+1)+scenario)=table_.at(bin*old_scenarios+scenario);
+    }
+  }
+  for(std::size_t bin(1); bin<=num_bins_; ++bin){
+    const float mc(mc_profile_.at(bin-1));
+    table.at(bin*(old_scenarios+1)+old_scenarios)=mc!=0.0?data.at(bin-1)/static_cast<double>(mc):0.0;
+  }
+  table_.swap(table);
+  names_.push_back(name);
+  return true;
+}
+
+std::size_t PileupWeights::GetNumBins() const{
+  return num_bins_;
+}
+
+std::size_t PileupWeights::GetNumScenarios() const{
+  return names_.size();
+}
+
+const std::string& PileupWeights::GetName(const std::size_t scenario) const{
+  return names_.at(scenario);
+}
+
+double PileupWeights::GetWeight(const std::size_t scenario, const double true_interactions) const{
+  return table_.at(FindBin(true_interactions)*names_.size()+scenario);
+}
+
+std::vector<float> PileupWeights::MakeProfile(const float* const begin, const std::size_t num_bins){
+  return std::vector<float>(begin, begin+num_bins);
+}
@@ -0,0 +1,289 @@
+#include "pileup_weights_3d.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "cache_io.hpp"
+
+namespace{
+  const char cache_magic[8]={'P','U','W','3','D','0','0','1'};
+  const std::size_t header_size(32);
+  const std::size_t matrix_size(PileupWeights3D::num_values*PileupWeights3D::num_values
+                                *PileupWeights3D::num_values);
+
+  //Poisson probabilities of 0 to num_values-1 interactions for each bin, computed
+  //exactly as in LumiReWeighting::weight3D_init so the sums agree to the last bit
+  std::vector<double> GetPoissonTable(const std::vector<double>& means){
+    const unsigned n(PileupWeights3D::num_values);
+    double factorial[PileupWeights3D::num_values];
+    double power[PileupWeights3D::num_values];
+    double base(1.0);
+    factorial[0]=1.0;
+    power[0]=1.0;
+    for(unsigned i(1); i<n; ++i){
+      base=base*float(i);
+      factorial[i]=base;
+    }
+    std::vector<double> table(means.size()*n);
+    for(std::size_t bin(0); bin<means.size(); ++bin){
+      const double mean(means[bin]);
+      if(mean<0.0){
+        std::cout << "LumiReweighting:BadInputValue" << " Your histogram generates MC luminosity values less than zero!"
+                  << " Please Check.  Terminating." << std::endl;
+      }
+      const double expval(mean==0.0?1.0:exp(-1.0*mean));
+      base=1.0;
+      for(unsigned i(1); i<n; ++i){
+        base=base*mean;
+        power[i]=base;
+      }
+      for(unsigned i(0); i<n; ++i){
+        table[bin*n+i]=power[i]/factorial[i]*expval;
+      }
+    }
+    return table;
+  }
+
+  struct Matrix3DJob{
+    const std::vector<double>* mc_table;
+    const std::vector<double>* mc_contents;
+    const std::vector<double>* data_table;
+    const std::vector<double>* data_contents;
+    double* weights;
+    double* mc_ints;
+    double* data_ints;
+    unsigned next_i;
+    pthread_mutex_t mutex;
+  };
+
+  void SumPoisson(const std::vector<double>& table, const std::vector<double>& contents,
+                  const unsigned i, double* const ints){
+    //Sums the bins into ints[j][k] for a fixed outer index i
+    const unsigned n(PileupWeights3D::num_values);
+    for(std::size_t bin(0); bin<contents.size(); ++bin){
+      const double* const probs(&table[bin*n]);
+      const double xweight(contents[bin]);
+      const double probi(probs[i]);
+      for(unsigned j(0); j<n; ++j){
+        const double probj(probs[j]);
+        double* const row(ints+j*n);
+        for(unsigned k(0); k<n; ++k){
+          row[k]=row[k]+probi*probj*probs[k]*xweight;
+        }
+      }
+    }
+  }
+
+  void* FillMatrices(void* arg){
+    Matrix3DJob& job(*static_cast<Matrix3DJob*>(arg));
+    const unsigned n(PileupWeights3D::num_values);
+    while(true){
+      pthread_mutex_lock(&job.mutex);
+      const unsigned i(job.next_i++);
+      pthread_mutex_unlock(&job.mutex);
+      if(i>=n) break;
+      const std::size_t offset(i*n*n);
+      SumPoisson(*job.mc_table, *job.mc_contents, i, job.mc_ints+offset);
+      SumPoisson(*job.data_table, *job.data_contents, i, job.data_ints+offset);
+      for(std::size_t jk(offset); jk<offset+n*n; ++jk){
+        job.weights[jk]=job.mc_ints[jk]>0.0?job.data_ints[jk]/job.mc_ints[jk]:0.0;
+      }
+    }
+    return NULL;
+  }
+}
+
+const unsigned PileupWeights3D::num_values;
+
+PileupWeights3D::PileupWeights3D(const std::vector<double>& mc_centers,
+                                 const std::vector<double>& mc_contents,
+                                 const std::vector<double>& data_centers,
+                                 const std::vector<double>& data_contents,
+                                 const float scale_factor,
+                                 const unsigned num_threads,
+                                 const std::string& cache_dir):
+  hash_(Hash(mc_centers, mc_contents, data_centers, data_contents, scale_factor)),
+  cache_file_name_(""),
+  map_(NULL),
+  map_size_(0),
+  computed_(0),
+  weights_(NULL),
+  mc_ints_(NULL),
+  data_ints_(NULL){
+  if(cache_dir!=""){
+    std::ostringstream name("");
+    name << cache_dir << "/pileup_weights_3d_" << std::hex;
+    name.width(16);
+    name.fill('0');
+    name << hash_ << ".bin";
+    cache_file_name_=name.str();
+  }
+  if(!MapCache()){
+    Compute(mc_centers, mc_contents, data_centers, data_contents, scale_factor, num_threads);
+    WriteCache();
+  }
+}
+
+PileupWeights3D::~PileupWeights3D(){
+  if(map_!=NULL) munmap(map_, map_size_);
+}
+
+const double* PileupWeights3D::GetWeights() const{
+  return weights_;
+}
+
+const double* PileupWeights3D::GetMcInts() const{
+  return mc_ints_;
+}
+
+const double* PileupWeights3D::GetDataInts() const{
+  return data_ints_;
+}
+
+uint64_t PileupWeights3D::GetHash() const{
+  return hash_;
+}
+
+const std::string& PileupWeights3D::GetCacheFileName() const{
+  return cache_file_name_;
+}
+
+bool PileupWeights3D::IsFromCache() const{
+  return map_!=NULL;
+}
+
+std::string PileupWeights3D::GetDefaultCacheDir(){
+  //Node-local scratch of batch jobs, else /tmp
+  const char* const tmp_dir(getenv("TMPDIR"));
+  return tmp_dir!=NULL && tmp_dir[0]!='\0'?tmp_dir:"/tmp";
+}
+
+uint64_t PileupWeights3D::Hash(const std::vector<double>& mc_centers,
+                               const std::vector<double>& mc_contents,
+                               const std::vector<double>& data_centers,
+                               const std::vector<double>& data_contents,
+                               const float scale_factor){
+  //Over the sizes and bytes of the inputs and the scale factor
+  CacheHash hash;
+  const std::vector<double>* const inputs[4]={&mc_centers, &mc_contents, &data_centers, &data_contents};
+  for(unsigned input(0); input<4; ++input){
+    const uint64_t size(inputs[input]->size());
+    hash.Add(&size, sizeof(size));
+    if(size>0) hash.Add(&inputs[input]->at(0), size*sizeof(double));
+  }
+  hash.Add(&scale_factor, sizeof(scale_factor));
+  return hash.Get();
+}
+
+bool PileupWeights3D::MapCache(){
+  if(cache_file_name_=="") return false;
+  const int fd(open(cache_file_name_.c_str(), O_RDONLY));
+  if(fd<0) return false;
+  const std::size_t expected_size(header_size+3*matrix_size*sizeof(double));
+  struct stat file_stat;
+  void* map(NULL);
+  if(fstat(fd, &file_stat)==0 && static_cast<std::size_t>(file_stat.st_size)==expected_size){
+    map=mmap(NULL, expected_size, PROT_READ, MAP_SHARED, fd, 0);
+    if(map==MAP_FAILED) map=NULL;
+  }
+  close(fd);
+  if(map==NULL){
+    std::cerr << "Warning: ignoring invalid 3D weight cache " << cache_file_name_ << '.' << std::endl;
+    return false;
+  }
+  const unsigned char* const bytes(static_cast<const unsigned char*>(map));
+  uint64_t hash(0), n(0);
+  memcpy(&hash, bytes+sizeof(cache_magic), sizeof(hash));
+  memcpy(&n, bytes+sizeof(cache_magic)+sizeof(hash), sizeof(n));
+  if(memcmp(bytes, cache_magic, sizeof(cache_magic))!=0 || hash!=hash_ || n!=num_values){
+    std::cerr << "Warning: ignoring invalid 3D weight cache " << cache_file_name_ << '.' << std::endl;
+    munmap(map, expected_size);
+    return false;
+  }
+  map_=map;
+  map_size_=expected_size;
+  SetPointers(reinterpret_cast<const double*>(bytes+header_size));
+  return true;
+}
+
+void PileupWeights3D::Compute(const std::vector<double>& mc_centers,
+                              const std::vector<double>& mc_contents,
+                              const std::vector<double>& data_centers,
+                              const std::vector<double>& data_contents,
+                              const float scale_factor,
+                              unsigned num_threads){
+  //For Summer 11 the MC means are truncated to integers
+  std::vector<double> mc_means(mc_centers.size()), data_means(data_centers.size());
+  for(std::size_t bin(0); bin<mc_centers.size(); ++bin){
+    mc_means[bin]=double(int(mc_centers[bin]));
+  }
+  for(std::size_t bin(0); bin<data_centers.size(); ++bin){
+    data_means[bin]=data_centers[bin]*scale_factor;
+  }
+  const std::vector<double> mc_table(GetPoissonTable(mc_means));
+  const std::vector<double> data_table(GetPoissonTable(data_means));
+
+  computed_.assign(3*matrix_size, 0.0);
+  SetPointers(&computed_.at(0));
+
+  Matrix3DJob job;
+  job.mc_table=&mc_table;
+  job.mc_contents=&mc_contents;
+  job.data_table=&data_table;
+  job.data_contents=&data_contents;
+  job.weights=&computed_.at(0);
+  job.mc_ints=&computed_.at(matrix_size);
+  job.data_ints=&computed_.at(2*matrix_size);
+  job.next_i=0;
+  pthread_mutex_init(&job.mutex, NULL);
+
+  if(num_threads==0){
+    const long num_cpus(sysconf(_SC_NPROCESSORS_ONLN));
+    num_threads=num_cpus>0?num_cpus:1;
+  }
+  if(num_threads>num_values) num_threads=num_values;
+  std::vector<pthread_t> threads(num_threads-1);
+  std::vector<bool> started(threads.size(), false);
+  for(std::size_t thread(0); thread<threads.size(); ++thread){
+    started.at(thread)=pthread_create(&threads.at(thread), NULL, FillMatrices, &job)==0;
+  }
+  FillMatrices(&job);
+  for(std::size_t thread(0); thread<threads.size(); ++thread){
+    if(started.at(thread)) pthread_join(threads.at(thread), NULL);
+  }
+  pthread_mutex_destroy(&job.mutex);
+}
+
+void PileupWeights3D::WriteCache() const{
+  //A job that cannot write the cache just recomputes next time
+  if(cache_file_name_=="") return;
+  AtomicFileWriter file(cache_file_name_);
+  std::ofstream& out(file.GetStream());
+  unsigned char header[header_size];
+  memset(header, 0, header_size);
+  const uint64_t n(num_values);
+  memcpy(header, cache_magic, sizeof(cache_magic));
+  memcpy(header+sizeof(cache_magic), &hash_, sizeof(hash_));
+  memcpy(header+sizeof(cache_magic)+sizeof(hash_), &n, sizeof(n));
+  out.write(reinterpret_cast<const char*>(header), header_size);
+  out.write(reinterpret_cast<const char*>(&computed_.at(0)), computed_.size()*sizeof(double));
+  if(!file.Commit()){
+    std::cerr << "Warning: could not write 3D weight cache " << cache_file_name_ << '.' << std::endl;
+  }
+}
+
+void PileupWeights3D::SetPointers(const double* const begin){
+  weights_=begin;
+  mc_ints_=begin+matrix_size;
+  data_ints_=begin+2*matrix_size;
+}
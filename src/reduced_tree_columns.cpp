@@ -0,0 +1,167 @@
+#include "reduced_tree_columns.hpp"
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iostream>
+#include <stdint.h>
+#include <sys/stat.h>
+#include "TFile.h"
+#include "TTree.h"
+#include "TLeaf.h"
+#include "TObjArray.h"
+#include "columnar_file.hpp"
+#include "utils.hpp"
+
+namespace{
+  bool GetColumnType(const std::string& type_name, ColumnType& type){
+    if(type_name=="Bool_t"){
+      type=kColumnBool;
+    }else if(type_name=="Char_t"){
+      type=kColumnChar;
+    }else if(type_name=="UChar_t"){
+      type=kColumnUInt8;
+    }else if(type_name=="Short_t"){
+      type=kColumnInt16;
+    }else if(type_name=="UShort_t"){
+      type=kColumnUInt16;
+    }else if(type_name=="Int_t"){
+      type=kColumnInt32;
+    }else if(type_name=="UInt_t"){
+      type=kColumnUInt32;
+    }else if(type_name=="Float_t"){
+      type=kColumnFloat;
+    }else if(type_name=="Double_t"){
+      type=kColumnDouble;
+    }else{
+      return false;
+    }
+    return true;
+  }
+
+  void CopyMetaInfo(TTree& meta_info, ColumnarWriter& writer){
+    if(meta_info.GetEntries()<=0) return;
+    std::string* original_file_name(NULL);
+    meta_info.SetBranchStatus("*",0);
+    setup(meta_info, "original_file_name", original_file_name);
+    meta_info.GetEntry(0);
+    if(original_file_name!=NULL) writer.SetMetadata("original_file_name", *original_file_name);
+
+    meta_info.SetBranchStatus("*",1);
+    meta_info.GetEntry(0);
+    TObjArray* leaves(meta_info.GetListOfLeaves());
+    for(int i(0); leaves!=NULL && i<leaves->GetSize(); ++i){
+      const TLeaf* leaf(static_cast<const TLeaf*>(leaves->At(i)));
+      const std::string name(leaf->GetName());
+      const std::string type_name(leaf->GetTypeName());
+      ColumnType type(kColumnFloat);
+      if(!GetColumnType(type_name, type) && type_name!="Long64_t" && type_name!="ULong64_t") continue;
+      std::ostringstream oss("");
+      oss.precision(15);
+      oss << leaf->GetValue();
+      writer.SetMetadata(name, oss.str());
+    }
+  }
+}
+
+bool ExportReducedTree(const std::string& root_file_name,
+                       const std::string& columns_file_name){
+  TFile file(root_file_name.c_str(), "read");
+  if(!file.IsOpen() || file.IsZombie()){
+    std::cerr << "Error: Could not open file " << root_file_name << '.' << std::endl;
+    return false;
+  }
+  TTree* tree(NULL);
+  file.GetObject("reduced_tree", tree);
+  if(tree==NULL){
+    std::cerr << "Error: Could not find tree reduced_tree in file " << root_file_name << '.' << std::endl;
+    return false;
+  }
+
+  ColumnarWriter writer(columns_file_name);
+  TObjArray* leaves(tree->GetListOfLeaves());
+  std::vector<unsigned> columns(0);
+  std::vector<std::string> names(0);
+  std::vector<double> buffers(leaves==NULL?0:leaves->GetSize());
+  for(int i(0); leaves!=NULL && i<leaves->GetSize(); ++i){
+    const TLeaf* leaf(static_cast<const TLeaf*>(leaves->At(i)));
+    ColumnType type(kColumnFloat);
+    if(!GetColumnType(leaf->GetTypeName(), type)){
+      std::cerr << "Warning: skipping branch " << leaf->GetName() << " of unsupported type "
+                << leaf->GetTypeName() << '.' << std::endl;
+      continue;
+    }
+    names.push_back(leaf->GetName());
+    columns.push_back(writer.AddColumn(names.back(), type));
+    tree->SetBranchAddress(names.back().c_str(), static_cast<void*>(&buffers.at(names.size()-1)));
+  }
+
+  const int num_entries(tree->GetEntries());
+  for(int entry(0); entry<num_entries; ++entry){
+    tree->GetEntry(entry);
+    for(std::size_t i(0); i<columns.size(); ++i){
+      writer.Append(columns.at(i), &buffers.at(i), 1);
+    }
+    writer.EndEntry();
+  }
+
+  TTree* meta_info(NULL);
+  file.GetObject("meta_info", meta_info);
+  if(meta_info!=NULL) CopyMetaInfo(*meta_info, writer);
+  writer.SetMetadata("source_file_name", root_file_name);
+
+  const bool success(writer.Close());
+  file.Close();
+  return success;
+}
+
+std::string GetReducedTreeColumnsName(const std::string& root_file_name){
+  std::string name(root_file_name);
+  const std::string::size_type pos(name.rfind(".root"));
+  if(pos!=std::string::npos && pos+5==name.size()) name.erase(pos);
+  return name+".columns";
+}
+
+bool ReducedTreeColumnsAreOutOfDate(const std::string& root_file_name){
+  struct stat columns_stat, root_stat;
+  if(stat(GetReducedTreeColumnsName(root_file_name).c_str(), &columns_stat)!=0) return true;
+  if(stat(root_file_name.c_str(), &root_stat)!=0) return false;
+  return columns_stat.st_mtime<root_stat.st_mtime;
+}
+
+ReducedTreeColumns::ReducedTreeColumns(const std::string& file_name):
+  file_(file_name){
+}
+
+bool ReducedTreeColumns::IsOpen() const{
+  return file_.IsOpen();
+}
+
+uint64_t ReducedTreeColumns::GetNumEntries() const{
+  return file_.GetNumEntries();
+}
+
+std::string ReducedTreeColumns::GetOriginalFileName() const{
+  return file_.GetMetadata("original_file_name");
+}
+
+int ReducedTreeColumns::GetReducedTreeVersion() const{
+  return file_.HasMetadata("reduced_tree_version")
+    ?atoi(file_.GetMetadata("reduced_tree_version").c_str()):-1;
+}
+
+std::string ReducedTreeColumns::GetMetaInfo(const std::string& name) const{
+  return file_.GetMetadata(name);
+}
+
+ColumnSpan<float> ReducedTreeColumns::GetFloat(const std::string& branch) const{
+  return file_.GetSpan<float>(branch);
+}
+
+ColumnSpan<uint8_t> ReducedTreeColumns::GetUInt8(const std::string& branch) const{
+  return file_.GetSpan<uint8_t>(branch);
+}
+
+const ColumnarFile& ReducedTreeColumns::GetFile() const{
+  return file_;
+}
@@ -2,15 +2,72 @@
 #include <ctime>
 #include <vector>
 #include <string>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <unistd.h>
 #include <set>
 #include <algorithm>
 #include <stdint.h>
+#include <sys/resource.h>
+#include "TFile.h"
 #include "timer.hpp"
 #include "event_handler.hpp"
 #include "event_number.hpp"
 #include "weights.hpp"
+#include "normalization_catalog.hpp"
+#include "pileup_weights.hpp"
+#include "pu_constants.hpp"
+#include "reduced_tree_writer.hpp"
+#include "cache_io.hpp"
+
+namespace{
+  const unsigned num_pileup_bins(60);
+
+  std::string GetPileupProfileName(const std::string& out_file_name){
+    std::string name(out_file_name);
+    const std::string::size_type pos(name.rfind(".root"));
+    if(pos!=std::string::npos && pos+5==name.size()) name.erase(pos);
+    return name+"_pu_profile.txt";
+  }
+
+  std::vector<float> ReadPileupProfile(const std::string& file_name,
+                                       const std::string& sample_name,
+                                       const int num_entries){
+    //Empty unless the file was made from the same sample with the same number of entries
+    std::ifstream file(file_name.c_str());
+    std::string cached_sample_name("");
+    int cached_entries(-1);
+    std::size_t num_bins(0);
+    if(!file.is_open() || !std::getline(file, cached_sample_name)
+       || !(file >> cached_entries >> num_bins)
+       || cached_sample_name!=sample_name || cached_entries!=num_entries || num_bins!=num_pileup_bins){
+      return std::vector<float>();
+    }
+    std::vector<float> profile(num_bins, 0.0);
+    for(std::size_t bin(0); bin<num_bins; ++bin){
+      if(!(file >> profile.at(bin))) return std::vector<float>();
+    }
+    return profile;
+  }
+
+  void WritePileupProfile(const std::string& file_name,
+                          const std::string& sample_name,
+                          const int num_entries,
+                          const std::vector<float>& profile){
+    AtomicFileWriter writer(file_name);
+    std::ofstream& file(writer.GetStream());
+    file << sample_name << '\n' << num_entries << ' ' << profile.size() << '\n' << std::setprecision(9);
+    for(std::size_t bin(0); bin<profile.size(); ++bin){
+      file << profile.at(bin) << '\n';
+    }
+    if(!writer.Commit()){
+      std::cerr << "Warning: Could not write pileup profile cache " << file_name << '.' << std::endl;
+    }
+  }
+}
 
-const uint16_t ReducedTreeMaker::reduced_tree_version(3);
+const uint16_t ReducedTreeMaker::reduced_tree_version(5);
 
 ReducedTreeMaker::ReducedTreeMaker(const std::string& in_file_name,
                                    const bool is_list,
@@ -18,7 +75,9 @@ ReducedTreeMaker::ReducedTreeMaker(const std::string& in_file_name,
   EventHandler(in_file_name, is_list, weight_in, false){
 }
 
-void ReducedTreeMaker::MakeReducedTree(const std::string& out_file_name){
+void ReducedTreeMaker::MakeReducedTree(const std::string& out_file_name, const bool certified_only,
+                                       const bool sample_pileup_profile,
+                                       const bool measured_normalization){
   TFile file(out_file_name.c_str(), "recreate");
   time_t raw_time;
   time(&raw_time);
@@ -34,12 +93,33 @@ void ReducedTreeMaker::MakeReducedTree(const std::string& out_file_name){
   std::set<EventNumber> eventList;
   file.cd();
 
-  const bool isRealData(sampleName.find("Run2012")!=std::string::npos);
-  std::vector<float> dataDist(pu::RunsThrough203002, pu::RunsThrough203002+60);
-  std::vector<float> MCDist(pu::Summer2012_S10, pu::Summer2012_S10+60);//QQQ this needs to change later for general pileup scenario
-  reweight::LumiReWeighting lumiWeights(MCDist, dataDist);
+  const bool isRealData(GetSampleTraits().is_data);
+  //Summer2012_S10 unless the sample's own profile is requested
+  std::vector<float> mc_pileup_profile(PileupWeights::MakeProfile(pu::Summer2012_S10, num_pileup_bins));
+  bool used_sample_pileup_profile(false);
+  if(sample_pileup_profile && !isRealData){
+    const std::vector<float> profile(GetSamplePileupProfile(out_file_name));
+    double num_profile_entries(0.0);
+    for(std::size_t bin(0); bin<profile.size(); ++bin) num_profile_entries+=profile.at(bin);
+    if(num_profile_entries>0.0){
+      mc_pileup_profile=profile;
+      used_sample_pileup_profile=true;
+    }else{
+      std::cerr << "Warning: empty pileup profile for " << sampleName << "; using Summer2012_S10." << std::endl;
+    }
+  }
+  PileupWeights pileup_weights(mc_pileup_profile);
+  //The first scenario is the nominal pu_weight, the others get branches of their own
+  pileup_weights.AddScenario("pu_weight", PileupWeights::MakeProfile(pu::RunsThrough203002, num_pileup_bins));
+  pileup_weights.AddScenario("pu_weight_203002_syst", PileupWeights::MakeProfile(pu::RunsThrough203002systVar, num_pileup_bins));
+  pileup_weights.AddScenario("pu_weight_207469", PileupWeights::MakeProfile(pu::RunsThrough207469, num_pileup_bins));
+  pileup_weights.AddScenario("pu_weight_207469_syst", PileupWeights::MakeProfile(pu::RunsThrough207469systVar, num_pileup_bins));
+  pileup_weights.AddScenario("pu_weight_202016", PileupWeights::MakeProfile(pu::RunsThrough202016, num_pileup_bins));
+  pileup_weights.AddScenario("pu_weight_199703", PileupWeights::MakeProfile(pu::RunsThrough199703, num_pileup_bins));
 
   TTree reduced_tree("reduced_tree","reduced_tree");
+  //Filled from its own thread, so compressing and writing baskets overlaps the event loop
+  ReducedTreeWriter tree_writer(reduced_tree);
   bool passes_JSON_cut(false), passes_PV_cut(false), passes_MET_cleaning_cut(false);
   bool passes_lepton_cut(false), passes_HT_cut(false), passes_MET_cut(false);
   bool passes_num_jets_cut(false), passes_b_tagging_cut(false);
@@ -78,6 +158,7 @@ void ReducedTreeMaker::MakeReducedTree(const std::string& out_file_name){
   uint8_t num_generated_emu_from_w_from_t(0);
   uint8_t num_generated_emu_from_w(0);
   uint8_t num_generated_emu(0);
+  uint8_t ttbar_decay(0);
 
   float cross_section(0.0);
   uint32_t events_of_this_type(0);
@@ -86,213 +167,301 @@ void ReducedTreeMaker::MakeReducedTree(const std::string& out_file_name){
 
   uint32_t run_here(0), event_here(0), lumiblock_here(0);
 
-  reduced_tree.Branch("passes_JSON_cut", &passes_JSON_cut);
-  reduced_tree.Branch("passes_PV_cut",&passes_PV_cut);
-  reduced_tree.Branch("passes_MET_cleaning_cut",&passes_MET_cleaning_cut);
-  reduced_tree.Branch("passes_lepton_cut",&passes_lepton_cut);
-  reduced_tree.Branch("passes_HT_cut",&passes_HT_cut);
-  reduced_tree.Branch("passes_MET_cut",&passes_MET_cut);
-  reduced_tree.Branch("passes_num_jets_cut",&passes_num_jets_cut);
-  reduced_tree.Branch("passes_b_tagging_cut",&passes_b_tagging_cut);
-  reduced_tree.Branch("passes_baseline_cuts",&passes_baseline_cuts);
-
-  reduced_tree.Branch("highest_jet_pt", &highest_jet_pt);
-  reduced_tree.Branch("second_highest_jet_pt", &second_highest_jet_pt);
-  reduced_tree.Branch("third_highest_jet_pt", &third_highest_jet_pt);
-  reduced_tree.Branch("fourth_highest_jet_pt", &fourth_highest_jet_pt);
-  reduced_tree.Branch("fifth_highest_jet_pt", &fifth_highest_jet_pt);
-
-  reduced_tree.Branch("highest_csv", &highest_csv);
-  reduced_tree.Branch("second_highest_csv", &second_highest_csv);
-  reduced_tree.Branch("third_highest_csv", &third_highest_csv);
-  reduced_tree.Branch("fourth_highest_csv", &fourth_highest_csv);
-  reduced_tree.Branch("fifth_highest_csv", &fifth_highest_csv);
-
-  reduced_tree.Branch("pu_true_num_interactions", &pu_true_num_interactions);
-  reduced_tree.Branch("num_primary_vertices", &num_primary_vertices);
-
-  reduced_tree.Branch("met_sig", &met_sig);
-  reduced_tree.Branch("met", &met);
-
-  reduced_tree.Branch("num_jets", &num_jets);
-  reduced_tree.Branch("num_csvl_jets", &num_csvl_jets);
-  reduced_tree.Branch("num_csvm_jets", &num_csvm_jets);
-  reduced_tree.Branch("num_csvt_jets", &num_csvt_jets);
-
-  reduced_tree.Branch("num_veto_electrons", &num_veto_electrons);
-  reduced_tree.Branch("num_veto_muons", &num_veto_muons);
-  reduced_tree.Branch("num_veto_taus", &num_veto_taus);
-  reduced_tree.Branch("num_veto_leptons", &num_veto_leptons);
-
-  reduced_tree.Branch("num_loose_electrons", &num_loose_electrons);
-  reduced_tree.Branch("num_loose_muons", &num_loose_muons);
-  reduced_tree.Branch("num_loose_taus", &num_loose_taus);
-  reduced_tree.Branch("num_loose_leptons", &num_loose_leptons);
-
-  reduced_tree.Branch("num_medium_electrons", &num_medium_electrons);
-  reduced_tree.Branch("num_medium_muons", &num_medium_muons);
-  reduced_tree.Branch("num_medium_taus", &num_medium_taus);
-  reduced_tree.Branch("num_medium_leptons", &num_medium_leptons);
-
-  reduced_tree.Branch("num_tight_electrons", &num_tight_electrons);
-  reduced_tree.Branch("num_tight_muons", &num_tight_muons);
-  reduced_tree.Branch("num_tight_taus", &num_tight_taus);
-  reduced_tree.Branch("num_tight_leptons", &num_tight_leptons);
-
-  reduced_tree.Branch("num_iso_tracks", &num_iso_tracks);
-
-  reduced_tree.Branch("ht_jets", &ht_jets);
-  reduced_tree.Branch("ht_jets_met", &ht_jets_met);
-  reduced_tree.Branch("ht_jets_leps", &ht_jets_leps);
-  reduced_tree.Branch("ht_jets_met_leps", &ht_jets_met_leps);
-
-  reduced_tree.Branch("mt2_best_csv_high_pt_loose_emu_Wmass", &mt2_best_csv_high_pt_loose_emu_Wmass);
-  reduced_tree.Branch("mt2_best_csv_high_pt_loose_emu_massless", &mt2_best_csv_high_pt_loose_emu_massless);
-  reduced_tree.Branch("mt_high_pt_loose_emu", &mt_high_pt_loose_emu);
-  reduced_tree.Branch("delta_phi_met_high_pt_loose_emu", &delta_phi_met_high_pt_loose_emu);
-  reduced_tree.Branch("delta_phi_W_high_pt_loose_emu", &delta_phi_W_high_pt_loose_emu);
-
-  reduced_tree.Branch("max_bl_mass_highest_pt_emu_two_best_csv",&max_bl_mass_highest_pt_emu_two_best_csv);
-  reduced_tree.Branch("min_bl_mass_highest_pt_emu_two_best_csv",&min_bl_mass_highest_pt_emu_two_best_csv);
-  reduced_tree.Branch("max_bl_mass_highest_pt_emu_all_csvm",&max_bl_mass_highest_pt_emu_all_csvm);
-  reduced_tree.Branch("min_bl_mass_highest_pt_emu_all_csvm",&min_bl_mass_highest_pt_emu_all_csvm);
-
-  reduced_tree.Branch("num_generated_emu_from_w_from_t",&num_generated_emu_from_w_from_t);
-  reduced_tree.Branch("num_generated_emu_from_w",&num_generated_emu_from_w);
-  reduced_tree.Branch("num_generated_emu",&num_generated_emu);
-
-  reduced_tree.Branch("full_weight", &full_weight);
-  reduced_tree.Branch("lumi_weight", &lumi_weight);
-  reduced_tree.Branch("pu_weight", &pu_weight);
-
-  reduced_tree.Branch("cross_section", &cross_section);
-  reduced_tree.Branch("events_of_this_type", &events_of_this_type);
+  tree_writer.Branch("passes_JSON_cut", passes_JSON_cut);
+  tree_writer.Branch("passes_PV_cut", passes_PV_cut);
+  tree_writer.Branch("passes_MET_cleaning_cut", passes_MET_cleaning_cut);
+  tree_writer.Branch("passes_lepton_cut", passes_lepton_cut);
+  tree_writer.Branch("passes_HT_cut", passes_HT_cut);
+  tree_writer.Branch("passes_MET_cut", passes_MET_cut);
+  tree_writer.Branch("passes_num_jets_cut", passes_num_jets_cut);
+  tree_writer.Branch("passes_b_tagging_cut", passes_b_tagging_cut);
+  tree_writer.Branch("passes_baseline_cuts", passes_baseline_cuts);
+
+  tree_writer.Branch("highest_jet_pt", highest_jet_pt);
+  tree_writer.Branch("second_highest_jet_pt", second_highest_jet_pt);
+  tree_writer.Branch("third_highest_jet_pt", third_highest_jet_pt);
+  tree_writer.Branch("fourth_highest_jet_pt", fourth_highest_jet_pt);
+  tree_writer.Branch("fifth_highest_jet_pt", fifth_highest_jet_pt);
+
+  tree_writer.Branch("highest_csv", highest_csv);
+  tree_writer.Branch("second_highest_csv", second_highest_csv);
+  tree_writer.Branch("third_highest_csv", third_highest_csv);
+  tree_writer.Branch("fourth_highest_csv", fourth_highest_csv);
+  tree_writer.Branch("fifth_highest_csv", fifth_highest_csv);
+
+  tree_writer.Branch("pu_true_num_interactions", pu_true_num_interactions);
+  tree_writer.Branch("num_primary_vertices", num_primary_vertices);
+
+  tree_writer.Branch("met_sig", met_sig);
+  tree_writer.Branch("met", met);
+
+  tree_writer.Branch("num_jets", num_jets);
+  tree_writer.Branch("num_csvl_jets", num_csvl_jets);
+  tree_writer.Branch("num_csvm_jets", num_csvm_jets);
+  tree_writer.Branch("num_csvt_jets", num_csvt_jets);
+
+  tree_writer.Branch("num_veto_electrons", num_veto_electrons);
+  tree_writer.Branch("num_veto_muons", num_veto_muons);
+  tree_writer.Branch("num_veto_taus", num_veto_taus);
+  tree_writer.Branch("num_veto_leptons", num_veto_leptons);
+
+  tree_writer.Branch("num_loose_electrons", num_loose_electrons);
+  tree_writer.Branch("num_loose_muons", num_loose_muons);
+  tree_writer.Branch("num_loose_taus", num_loose_taus);
+  tree_writer.Branch("num_loose_leptons", num_loose_leptons);
+
+  tree_writer.Branch("num_medium_electrons", num_medium_electrons);
+  tree_writer.Branch("num_medium_muons", num_medium_muons);
+  tree_writer.Branch("num_medium_taus", num_medium_taus);
+  tree_writer.Branch("num_medium_leptons", num_medium_leptons);
+
+  tree_writer.Branch("num_tight_electrons", num_tight_electrons);
+  tree_writer.Branch("num_tight_muons", num_tight_muons);
+  tree_writer.Branch("num_tight_taus", num_tight_taus);
+  tree_writer.Branch("num_tight_leptons", num_tight_leptons);
+
+  tree_writer.Branch("num_iso_tracks", num_iso_tracks);
+
+  tree_writer.Branch("ht_jets", ht_jets);
+  tree_writer.Branch("ht_jets_met", ht_jets_met);
+  tree_writer.Branch("ht_jets_leps", ht_jets_leps);
+  tree_writer.Branch("ht_jets_met_leps", ht_jets_met_leps);
+
+  tree_writer.Branch("mt2_best_csv_high_pt_loose_emu_Wmass", mt2_best_csv_high_pt_loose_emu_Wmass);
+  tree_writer.Branch("mt2_best_csv_high_pt_loose_emu_massless", mt2_best_csv_high_pt_loose_emu_massless);
+  tree_writer.Branch("mt_high_pt_loose_emu", mt_high_pt_loose_emu);
+  tree_writer.Branch("delta_phi_met_high_pt_loose_emu", delta_phi_met_high_pt_loose_emu);
+  tree_writer.Branch("delta_phi_W_high_pt_loose_emu", delta_phi_W_high_pt_loose_emu);
+
+  tree_writer.Branch("max_bl_mass_highest_pt_emu_two_best_csv", max_bl_mass_highest_pt_emu_two_best_csv);
+  tree_writer.Branch("min_bl_mass_highest_pt_emu_two_best_csv", min_bl_mass_highest_pt_emu_two_best_csv);
+  tree_writer.Branch("max_bl_mass_highest_pt_emu_all_csvm", max_bl_mass_highest_pt_emu_all_csvm);
+  tree_writer.Branch("min_bl_mass_highest_pt_emu_all_csvm", min_bl_mass_highest_pt_emu_all_csvm);
+
+  tree_writer.Branch("num_generated_emu_from_w_from_t", num_generated_emu_from_w_from_t);
+  tree_writer.Branch("num_generated_emu_from_w", num_generated_emu_from_w);
+  tree_writer.Branch("num_generated_emu", num_generated_emu);
+  tree_writer.Branch("ttbar_decay", ttbar_decay);
+
+  tree_writer.Branch("full_weight", full_weight);
+  tree_writer.Branch("lumi_weight", lumi_weight);
+  tree_writer.Branch("pu_weight", pu_weight);
+  std::vector<float> alternative_pu_weights(pileup_weights.GetNumScenarios()-1, 0.0);
+  for(std::size_t scenario(1); scenario<pileup_weights.GetNumScenarios(); ++scenario){
+    tree_writer.Branch(pileup_weights.GetName(scenario), alternative_pu_weights.at(scenario-1));
+  }
+
+  tree_writer.Branch("cross_section", cross_section);
+  tree_writer.Branch("events_of_this_type", events_of_this_type);
  
-  reduced_tree.Branch("mass1", &mass1);
-  reduced_tree.Branch("mass2", &mass2);
+  tree_writer.Branch("mass1", mass1);
+  tree_writer.Branch("mass2", mass2);
 
-  reduced_tree.Branch("run", &run_here);
-  reduced_tree.Branch("event", &event_here);
-  reduced_tree.Branch("lumiblock", &lumiblock_here);
+  tree_writer.Branch("run", run_here);
+  tree_writer.Branch("event", event_here);
+  tree_writer.Branch("lumiblock", lumiblock_here);
 
   WeightCalculator wc(19399.0);
+  //Normalize to the events actually in the input instead of the built-in table
+  bool used_measured_normalization(false);
+  double sample_scale_factor(scaleFactor);
+  if(measured_normalization && !isRealData){
+    const GeneratedEventCounts counts(GetSampleEventCounts());
+    if(counts.total>0){
+      wc.SetTotalEvents(sampleName, counts);
+      sample_scale_factor=wc.GetWeight(sampleName);
+      used_measured_normalization=true;
+    }else{
+      std::cerr << "Warning: no generated events counted for " << sampleName << "; using the built-in table." << std::endl;
+    }
+  }
 
+  tree_writer.Start();
   Timer timer(GetTotalEntries());
+  const unsigned get_entry_section(timer.AddSection("get_entry"));
+  const unsigned duplicate_check_section(timer.AddSection("duplicate_check"));
+  const unsigned selections_section(timer.AddSection("selections"));
+  const unsigned mt2_section(timer.AddSection("mt2"));
+  const unsigned bl_masses_section(timer.AddSection("bl_masses"));
+  const unsigned generator_section(timer.AddSection("generator"));
+  const unsigned weights_section(timer.AddSection("weights"));
+  const unsigned fill_section(timer.AddSection("fill"));
+  const unsigned certified_entries_section(timer.AddSection("certified_entries"));
+  ULong64_t bytes_read_uncompressed(0);
+  uint32_t duplicate_events_skipped(0);
+  const Long64_t start_file_bytes_read(TFile::GetFileBytesRead());
+  std::vector<unsigned> entries(0);
+  //Started before the certified-entries pass so the section fits within the wall time
   timer.Start();
-  for(int i(0); i<GetTotalEntries(); ++i){
-    if(i%1000==0 && i!=0){
+  if(certified_only && isRealData){
+    const ScopedTimer scope(timer, certified_entries_section);
+    entries=GetCertifiedEntries();
+  }else{
+    for(int i(0); i<GetTotalEntries(); ++i) entries.push_back(i);
+  }
+  uint32_t uncertified_events_skipped(GetTotalEntries()>0?GetTotalEntries()-entries.size():0);
+  timer.SetNumIterations(entries.size());
+  for(std::size_t entry(0); entry<entries.size(); ++entry){
+    const unsigned i(entries.at(entry));
+    if(entry%1000==0 && entry!=0){
       timer.PrintRemainingTime();
     }
     timer.Iterate();
-    GetEntry(i);
-
-    std::pair<std::set<EventNumber>::iterator, bool> returnVal(eventList.insert(EventNumber(run, event, lumiblock)));
-    if(!returnVal.second) continue;
-    
-    // Saving our cuts for the reduced tree
-    passes_JSON_cut=PassesJSONCut();
-    passes_PV_cut=PassesPVCut();
-    passes_MET_cleaning_cut=PassesMETCleaningCut();
-    passes_lepton_cut=PassesLeptonCut();
-    passes_HT_cut=PassesHTCut();
-    passes_MET_cut=PassesMETCut();
-    passes_num_jets_cut=PassesNumJetsCut();
-    passes_b_tagging_cut=PassesBTaggingCut();
-
-    highest_jet_pt=GetHighestJetPt(1);
-    second_highest_jet_pt=GetHighestJetPt(2);
-    third_highest_jet_pt=GetHighestJetPt(3);
-    fourth_highest_jet_pt=GetHighestJetPt(4);
-    fifth_highest_jet_pt=GetHighestJetPt(5);
-
-    highest_csv=GetHighestJetCSV(1);
-    second_highest_csv=GetHighestJetCSV(2);
-    third_highest_csv=GetHighestJetCSV(3);
-    fourth_highest_csv=GetHighestJetCSV(4);
-    fifth_highest_csv=GetHighestJetCSV(5);
-
-    pu_true_num_interactions=GetNumInteractions();
-    num_primary_vertices=GetNumVertices();
-
-    met_sig=pfmets_fullSignif;
-    met=pfTypeImets_et->at(0);
-
-    num_jets=GetNumGoodJets();
-    num_csvl_jets=GetNumCSVLJets();
-    num_csvm_jets=GetNumCSVMJets();
-    num_csvt_jets=GetNumCSVTJets();
-
-    num_veto_electrons=GetNumElectrons(0);
-    num_veto_muons=GetNumMuons(0);
-    num_veto_taus=GetNumTaus(0);
-    num_veto_leptons=num_veto_electrons+num_veto_muons+num_veto_taus;
-    num_loose_electrons=GetNumElectrons(1);
-    num_loose_muons=GetNumMuons(1);
-    num_loose_taus=GetNumTaus(1);
-    num_loose_leptons=num_loose_electrons+num_loose_muons+num_loose_taus;
-    num_medium_electrons=GetNumElectrons(2);
-    num_medium_muons=GetNumMuons(2);
-    num_medium_taus=GetNumTaus(2);
-    num_medium_leptons=num_medium_electrons+num_medium_muons+num_medium_taus;
-    num_tight_electrons=GetNumElectrons(3);
-    num_tight_muons=GetNumMuons(3);
-    num_tight_taus=GetNumTaus(3);
-    num_tight_leptons=num_tight_electrons+num_tight_muons+num_tight_taus;
-    num_iso_tracks=NewGetNumIsoTracks();
-
-    mt2_best_csv_high_pt_loose_emu_Wmass=GetMT2(80.399);
-    mt2_best_csv_high_pt_loose_emu_massless=GetMT2(0.0);
-    mt_high_pt_loose_emu=GetMT();
-    delta_phi_met_high_pt_loose_emu=GetDeltaPhiMETLepton();
-    delta_phi_W_high_pt_loose_emu=GetDeltaPhiWLepton();
-
-    ht_jets=GetHT(false, false);
-    ht_jets_met=GetHT(true, false);
-    ht_jets_leps=GetHT(false, true);
-    ht_jets_met_leps=GetHT(true, true);
-
-    std::vector<double> bl_masses_two_best(GetBLInvariantMasses(2, -std::numeric_limits<float>::max()));
-    std::vector<double> bl_masses_all_csvm(GetBLInvariantMasses(0, EventHandler::CSVMCut));
-    if(bl_masses_two_best.size()){
-      max_bl_mass_highest_pt_emu_two_best_csv=*std::max_element(bl_masses_two_best.begin(), bl_masses_two_best.end());
-      min_bl_mass_highest_pt_emu_two_best_csv=*std::min_element(bl_masses_two_best.begin(), bl_masses_two_best.end());
-    }else{
-      max_bl_mass_highest_pt_emu_two_best_csv=0.0;
-      min_bl_mass_highest_pt_emu_two_best_csv=0.0;
+    {
+      const ScopedTimer scope(timer, get_entry_section);
+      bytes_read_uncompressed+=GetEntry(i);
     }
-    if(bl_masses_all_csvm.size()){
-      max_bl_mass_highest_pt_emu_all_csvm=*std::max_element(bl_masses_all_csvm.begin(), bl_masses_all_csvm.end());
-      min_bl_mass_highest_pt_emu_all_csvm=*std::min_element(bl_masses_all_csvm.begin(), bl_masses_all_csvm.end());
-    }else{
-      max_bl_mass_highest_pt_emu_all_csvm=0.0;
-      min_bl_mass_highest_pt_emu_all_csvm=0.0;
+
+    {
+      const ScopedTimer scope(timer, duplicate_check_section);
+      std::pair<std::set<EventNumber>::iterator, bool> returnVal(eventList.insert(EventNumber(run, event, lumiblock)));
+      if(!returnVal.second){
+        ++duplicate_events_skipped;
+        continue;
+      }
+    }
+
+    {
+      const ScopedTimer scope(timer, selections_section);
+      // Saving our cuts for the reduced tree
+      passes_JSON_cut=PassesJSONCut();
+      passes_PV_cut=PassesPVCut();
+      passes_MET_cleaning_cut=PassesMETCleaningCut();
+      passes_lepton_cut=PassesLeptonCut();
+      passes_HT_cut=PassesHTCut();
+      passes_MET_cut=PassesMETCut();
+      passes_num_jets_cut=PassesNumJetsCut();
+      passes_b_tagging_cut=PassesBTaggingCut();
+
+      highest_jet_pt=GetHighestJetPt(1);
+      second_highest_jet_pt=GetHighestJetPt(2);
+      third_highest_jet_pt=GetHighestJetPt(3);
+      fourth_highest_jet_pt=GetHighestJetPt(4);
+      fifth_highest_jet_pt=GetHighestJetPt(5);
+
+      highest_csv=GetHighestJetCSV(1);
+      second_highest_csv=GetHighestJetCSV(2);
+      third_highest_csv=GetHighestJetCSV(3);
+      fourth_highest_csv=GetHighestJetCSV(4);
+      fifth_highest_csv=GetHighestJetCSV(5);
+
+      pu_true_num_interactions=GetNumInteractions();
+      num_primary_vertices=GetNumVertices();
+
+      met_sig=pfmets_fullSignif;
+      met=pfTypeImets_et->at(0);
+
+      num_jets=GetNumGoodJets();
+      num_csvl_jets=GetNumCSVLJets();
+      num_csvm_jets=GetNumCSVMJets();
+      num_csvt_jets=GetNumCSVTJets();
+
+      num_veto_electrons=GetNumElectrons(0);
+      num_veto_muons=GetNumMuons(0);
+      num_veto_taus=GetNumTaus(0);
+      num_veto_leptons=num_veto_electrons+num_veto_muons+num_veto_taus;
+      num_loose_electrons=GetNumElectrons(1);
+      num_loose_muons=GetNumMuons(1);
+      num_loose_taus=GetNumTaus(1);
+      num_loose_leptons=num_loose_electrons+num_loose_muons+num_loose_taus;
+      num_medium_electrons=GetNumElectrons(2);
+      num_medium_muons=GetNumMuons(2);
+      num_medium_taus=GetNumTaus(2);
+      num_medium_leptons=num_medium_electrons+num_medium_muons+num_medium_taus;
+      num_tight_electrons=GetNumElectrons(3);
+      num_tight_muons=GetNumMuons(3);
+      num_tight_taus=GetNumTaus(3);
+      num_tight_leptons=num_tight_electrons+num_tight_muons+num_tight_taus;
+      num_iso_tracks=NewGetNumIsoTracks();
+
+      ht_jets=GetHT(false, false);
+      ht_jets_met=GetHT(true, false);
+      ht_jets_leps=GetHT(false, true);
+      ht_jets_met_leps=GetHT(true, true);
+    }
+
+    {
+      const ScopedTimer scope(timer, mt2_section);
+      mt2_best_csv_high_pt_loose_emu_Wmass=GetMT2(80.399);
+      mt2_best_csv_high_pt_loose_emu_massless=GetMT2(0.0);
+      mt_high_pt_loose_emu=GetMT();
+      delta_phi_met_high_pt_loose_emu=GetDeltaPhiMETLepton();
+      delta_phi_W_high_pt_loose_emu=GetDeltaPhiWLepton();
+    }
+
+    {
+      const ScopedTimer scope(timer, bl_masses_section);
+      std::vector<double> bl_masses_two_best(GetBLInvariantMasses(2, -std::numeric_limits<float>::max()));
+      std::vector<double> bl_masses_all_csvm(GetBLInvariantMasses(0, EventHandler::CSVMCut));
+      if(bl_masses_two_best.size()){
+        max_bl_mass_highest_pt_emu_two_best_csv=*std::max_element(bl_masses_two_best.begin(), bl_masses_two_best.end());
+        min_bl_mass_highest_pt_emu_two_best_csv=*std::min_element(bl_masses_two_best.begin(), bl_masses_two_best.end());
+      }else{
+        max_bl_mass_highest_pt_emu_two_best_csv=0.0;
+        min_bl_mass_highest_pt_emu_two_best_csv=0.0;
+      }
+      if(bl_masses_all_csvm.size()){
+        max_bl_mass_highest_pt_emu_all_csvm=*std::max_element(bl_masses_all_csvm.begin(), bl_masses_all_csvm.end());
+        min_bl_mass_highest_pt_emu_all_csvm=*std::min_element(bl_masses_all_csvm.begin(), bl_masses_all_csvm.end());
+      }else{
+        max_bl_mass_highest_pt_emu_all_csvm=0.0;
+        min_bl_mass_highest_pt_emu_all_csvm=0.0;
+      }
     }
-    
-    num_generated_emu_from_w_from_t=GetNumberOfGeneratedEMu(true, true);
-    num_generated_emu_from_w=GetNumberOfGeneratedEMu(true, false);
-    num_generated_emu=GetNumberOfGeneratedEMu(false, false);
 
-    mass1=GetMass1();
-    mass2=GetMass2();
+    {
+      const ScopedTimer scope(timer, generator_section);
+      num_generated_emu_from_w_from_t=GetNumberOfGeneratedEMu(true, true);
+      num_generated_emu_from_w=GetNumberOfGeneratedEMu(true, false);
+      num_generated_emu=GetNumberOfGeneratedEMu(false, false);
+      ttbar_decay=GetTtbarDecay();
 
-    double this_scale_factor(scaleFactor);
-    if(sampleName.find("SMS-")!=std::string::npos){
-      this_scale_factor=wc.GetWeight(sampleName, mass1, mass2);
+      mass1=GetMass1();
+      mass2=GetMass2();
     }
-    cross_section=wc.GetCrossSection(sampleName, mass1, mass2);
-    events_of_this_type=wc.GetTotalEvents(sampleName, mass1, mass2);
 
-    pu_weight=isRealData?1.0:GetPUWeight(lumiWeights);
-    lumi_weight=this_scale_factor;
-    full_weight=pu_weight*lumi_weight;
+    {
+      const ScopedTimer scope(timer, weights_section);
+      double this_scale_factor(sample_scale_factor);
+      if(GetSampleTraits().is_sms){
+        this_scale_factor=wc.GetWeight(sampleName, mass1, mass2);
+      }
+      cross_section=wc.GetCrossSection(sampleName, mass1, mass2);
+      events_of_this_type=wc.GetTotalEvents(sampleName, mass1, mass2);
+
+      const float* const pu_weights(pileup_weights.GetWeights(GetNumInteractions()));
+      pu_weight=isRealData?1.0:pu_weights[0];
+      for(std::size_t scenario(1); scenario<pileup_weights.GetNumScenarios(); ++scenario){
+        alternative_pu_weights.at(scenario-1)=isRealData?1.0:pu_weights[scenario];
+      }
+      lumi_weight=this_scale_factor;
+      full_weight=pu_weight*lumi_weight;
+    }
 
-    run_here=run;
-    event_here=event;
-    lumiblock_here=lumiblock;
+    {
+      const ScopedTimer scope(timer, fill_section);
+      run_here=run;
+      event_here=event;
+      lumiblock_here=lumiblock;
 
-    reduced_tree.Fill(); 
+      tree_writer.Fill();
+    }
   }
+  tree_writer.Finish();
   reduced_tree.Write();
+  timer.PrintSections();
+
+  //The cfA cache is stored uncompressed, so both byte counts are the same for it
+  ULong64_t bytes_read_compressed(cfACache!=NULL?bytes_read_uncompressed
+                                  :TFile::GetFileBytesRead()-start_file_bytes_read);
+  ULong64_t bytes_written(file.GetBytesWritten());
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  double wall_seconds(timer.GetElapsedTime());
+  double cpu_seconds(usage.ru_utime.tv_sec+1.e-6*usage.ru_utime.tv_usec
+                     +usage.ru_stime.tv_sec+1.e-6*usage.ru_stime.tv_usec);
+  double events_per_second(wall_seconds>0.0?entries.size()/wall_seconds:0.0);
+  ULong64_t peak_rss_bytes(1024*static_cast<ULong64_t>(usage.ru_maxrss));
 
   time(&raw_time);
   struct tm * utc_creation_time(gmtime(&raw_time));
@@ -326,8 +495,61 @@ void ReducedTreeMaker::MakeReducedTree(const std::string& out_file_name){
   meta_info.Branch("utc_start_minute", &utc_start_minute);
   meta_info.Branch("utc_start_second", &utc_start_second);
   meta_info.Branch("utc_start_isdst", &utc_start_isdst);
+
+  meta_info.Branch("wall_seconds", &wall_seconds);
+  meta_info.Branch("cpu_seconds", &cpu_seconds);
+  meta_info.Branch("events_per_second", &events_per_second);
+  meta_info.Branch("bytes_read_compressed", &bytes_read_compressed);
+  meta_info.Branch("bytes_read_uncompressed", &bytes_read_uncompressed);
+  meta_info.Branch("bytes_written", &bytes_written);
+  meta_info.Branch("peak_rss_bytes", &peak_rss_bytes);
+  meta_info.Branch("duplicate_events_skipped", &duplicate_events_skipped);
+  meta_info.Branch("uncertified_events_skipped", &uncertified_events_skipped);
+  meta_info.Branch("sample_pileup_profile", &used_sample_pileup_profile);
+  meta_info.Branch("measured_normalization", &used_measured_normalization);
+
+  std::vector<double> timer_seconds(timer.GetNumSections());
+  std::vector<uint32_t> timer_calls(timer.GetNumSections());
+  for(unsigned section(0); section<timer.GetNumSections(); ++section){
+    const std::string name("timer_"+timer.GetSectionName(section));
+    timer_seconds.at(section)=timer.GetSectionTime(section);
+    timer_calls.at(section)=timer.GetSectionCalls(section);
+    meta_info.Branch((name+"_seconds").c_str(), &timer_seconds.at(section));
+    meta_info.Branch((name+"_calls").c_str(), &timer_calls.at(section));
+  }
   meta_info.Fill();
   meta_info.Write();
 
   file.Close();
 }
+
+std::vector<float> ReducedTreeMaker::GetSamplePileupProfile(const std::string& out_file_name){
+  //Cached next to the output, so remaking a reduced_tree does not read the sample twice
+  const std::string cache_name(GetPileupProfileName(out_file_name));
+  std::vector<float> profile(ReadPileupProfile(cache_name, sampleName, GetTotalEntries()));
+  if(profile.size()==num_pileup_bins){
+    std::cout << "Using pileup profile from " << cache_name << std::endl;
+    return profile;
+  }
+  const long num_threads(sysconf(_SC_NPROCESSORS_ONLN));
+  profile=GetPileupProfile(num_pileup_bins, num_threads>0?num_threads:1);
+  if(profile.size()==num_pileup_bins){
+    WritePileupProfile(cache_name, sampleName, GetTotalEntries(), profile);
+  }
+  return profile;
+}
+
+GeneratedEventCounts ReducedTreeMaker::GetSampleEventCounts(){
+  //Looked up in the catalog first, so only the first job on a dataset counts it
+  NormalizationCatalog catalog;
+  const uint64_t key(NormalizationCatalog::GetKey(GetInputFiles()));
+  GeneratedEventCounts counts;
+  if(catalog.Find(sampleName, key, counts)){
+    std::cout << "Using generated event counts from " << catalog.GetFileName() << std::endl;
+    return counts;
+  }
+  const long num_threads(sysconf(_SC_NPROCESSORS_ONLN));
+  counts=CountGeneratedEvents(num_threads>0?num_threads:1);
+  if(counts.total>0) catalog.Store(sampleName, key, counts);
+  return counts;
+}
@@ -0,0 +1,154 @@
+#include "reduced_tree_writer.hpp"
+#include <cstring>
+#include <string>
+#include <vector>
+#include <deque>
+#include <iostream>
+#include <stdint.h>
+#include <pthread.h>
+#include "TTree.h"
+#include "TThread.h"
+
+ReducedTreeWriter::ReducedTreeWriter(TTree& tree,
+                                     const std::size_t records_per_block,
+                                     const std::size_t num_blocks):
+  tree_(tree),
+  columns_(0),
+  slots_(),
+  record_size_(0),
+  records_per_block_(records_per_block>0?records_per_block:1),
+  blocks_(num_blocks>0?num_blocks:1),
+  block_sizes_(num_blocks>0?num_blocks:1, 0),
+  first_full_(0),
+  num_full_(0),
+  fill_block_(0),
+  num_filled_(0),
+  stop_(false),
+  running_(false),
+  mutex_(),
+  changed_(),
+  thread_(){
+  pthread_mutex_init(&mutex_, NULL);
+  pthread_cond_init(&changed_, NULL);
+}
+
+ReducedTreeWriter::~ReducedTreeWriter(){
+  Finish();
+  pthread_cond_destroy(&changed_);
+  pthread_mutex_destroy(&mutex_);
+}
+
+bool ReducedTreeWriter::Start(){
+  if(running_) return true;
+  if(columns_.size()==0) return false;
+  for(std::size_t block(0); block<blocks_.size(); ++block){
+    blocks_.at(block).resize(records_per_block_*record_size_);
+  }
+  //ROOT's global state (gDirectory, the list of files) is only guarded once
+  //thread support is initialized; the input chains keep opening files meanwhile
+  TThread::Initialize();
+  stop_=false;
+  running_=pthread_create(&thread_, NULL, Run, this)==0;
+  if(!running_){
+    std::cerr << "Warning: could not start the reduced_tree writer thread; filling directly." << std::endl;
+  }
+  return running_;
+}
+
+void ReducedTreeWriter::Fill(){
+  if(!running_){
+    for(std::size_t column(0); column<columns_.size(); ++column){
+      const Column& this_column(columns_.at(column));
+      memcpy(this_column.slot, this_column.source, this_column.size);
+    }
+    tree_.Fill();
+    return;
+  }
+  if(num_filled_==0){
+    //Waits for the writer only if every block is still queued
+    pthread_mutex_lock(&mutex_);
+    while(num_full_==blocks_.size()) pthread_cond_wait(&changed_, &mutex_);
+    fill_block_=(first_full_+num_full_)%blocks_.size();
+    pthread_mutex_unlock(&mutex_);
+  }
+  char* const record(&blocks_.at(fill_block_).at(num_filled_*record_size_));
+  for(std::size_t column(0); column<columns_.size(); ++column){
+    const Column& this_column(columns_.at(column));
+    memcpy(record+this_column.offset, this_column.source, this_column.size);
+  }
+  ++num_filled_;
+  if(num_filled_==records_per_block_) CommitBlock();
+}
+
+void ReducedTreeWriter::Finish(){
+  if(!running_) return;
+  if(num_filled_>0) CommitBlock();
+  pthread_mutex_lock(&mutex_);
+  stop_=true;
+  pthread_cond_broadcast(&changed_);
+  pthread_mutex_unlock(&mutex_);
+  pthread_join(thread_, NULL);
+  running_=false;
+}
+
+void* ReducedTreeWriter::AddColumn(const void* source, const std::size_t size){
+  //Each branch buffer is a vector of its own in a deque, so its address stays
+  //valid as columns are added
+  slots_.push_back(std::vector<uint64_t>((size+sizeof(uint64_t)-1)/sizeof(uint64_t), 0));
+  void* const slot(&slots_.back().at(0));
+  if(running_){
+    std::cerr << "Error: branch added to the reduced_tree after the writer started; it will not be filled." << std::endl;
+    return slot;
+  }
+  Column column;
+  column.source=source;
+  column.slot=slot;
+  column.size=size;
+  column.offset=record_size_;
+  columns_.push_back(column);
+  record_size_+=size;
+  return slot;
+}
+
+void ReducedTreeWriter::CommitBlock(){
+  pthread_mutex_lock(&mutex_);
+  block_sizes_.at(fill_block_)=num_filled_;
+  ++num_full_;
+  pthread_cond_broadcast(&changed_);
+  pthread_mutex_unlock(&mutex_);
+  num_filled_=0;
+}
+
+void ReducedTreeWriter::WriteRecord(const char* record){
+  for(std::size_t column(0); column<columns_.size(); ++column){
+    const Column& this_column(columns_.at(column));
+    memcpy(this_column.slot, record+this_column.offset, this_column.size);
+  }
+  tree_.Fill();
+}
+
+void* ReducedTreeWriter::Run(void* writer){
+  static_cast<ReducedTreeWriter*>(writer)->Work();
+  return NULL;
+}
+
+void ReducedTreeWriter::Work(){
+  //Writes full blocks in the order they were committed. A block stays counted
+  //in num_full_ until it is written, so the event loop never refills it early.
+  pthread_mutex_lock(&mutex_);
+  while(true){
+    while(num_full_==0 && !stop_) pthread_cond_wait(&changed_, &mutex_);
+    if(num_full_==0) break;
+    const std::vector<char>& block(blocks_.at(first_full_));
+    const std::size_t num_records(block_sizes_.at(first_full_));
+    pthread_mutex_unlock(&mutex_);
+    for(std::size_t record(0); record<num_records; ++record){
+      WriteRecord(&block.at(record*record_size_));
+    }
+    pthread_mutex_lock(&mutex_);
+    first_full_=(first_full_+1)%blocks_.size();
+    --num_full_;
+    pthread_cond_broadcast(&changed_);
+  }
+  pthread_mutex_unlock(&mutex_);
+}
@@ -0,0 +1,32 @@
+#include "sample_traits.hpp"
+#include <string>
+#include <sstream>
+
+namespace{
+  bool Contains(const std::string& name, const std::string& part){
+    return name.find(part)!=std::string::npos;
+  }
+
+  int ParsecfAVersion(const std::string& name){
+    const std::string::size_type pos(name.rfind("_v"));
+    if(pos==std::string::npos || pos>=name.size()-2) return 0;
+    std::istringstream iss(name.substr(pos+2));
+    int version(0);
+    iss >> version;
+    return iss.fail()?0:version;
+  }
+}
+
+SampleTraits::SampleTraits(const std::string& sample_name):
+  name(sample_name),
+  cfa_version(ParsecfAVersion(sample_name)),
+  is_data(Contains(sample_name, "Run2012")),
+  is_sms(Contains(sample_name, "SMS-")),
+  is_ttbar(Contains(sample_name, "TTJets") || Contains(sample_name, "TT_")),
+  uses_prompt_reco_json(is_data && Contains(sample_name, "PromptReco")),
+  uses_24aug_json(is_data && Contains(sample_name, "24Aug")),
+  uses_13jul_json(is_data && Contains(sample_name, "13Jul")),
+  skips_hbhe_filter(Contains(sample_name, "TChihh") || Contains(sample_name, "HbbHbb")),
+  skips_ecal_laser_filter(Contains(sample_name, "_v66")),
+  skips_beta_cut(cfa_version<69 || Contains(sample_name, "SMS-TChiHH")){
+}
@@ -2,16 +2,29 @@
 #include <ctime>
 #include <cstdio>
 #include <cmath>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <time.h>
 
 Timer::Timer(const unsigned long itsIn):
-  startTime(0),
+  startTime(GetNanoseconds()),
   numIts(itsIn),
-  curIts(0){
+  curIts(0),
+  sectionNames(0),
+  sectionTimes(0),
+  sectionCalls(0){
+}
+
+uint64_t Timer::GetNanoseconds(){
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec)*1000000000u+now.tv_nsec;
 }
 
 void Timer::Start(){
   curIts=0;
-  time(&startTime);
+  startTime=GetNanoseconds();
 }
 
 void Timer::SetNumIterations(const unsigned long itsIn){
@@ -22,13 +35,15 @@ void Timer::Iterate(){
   ++curIts;
 }
 
+double Timer::GetElapsedTime() const{
+  return 1.e-9*(GetNanoseconds()-startTime);
+}
+
 double Timer::GetRemainingTime() const{
   if(curIts==0){
     return 0.0;
   }else{
-    time_t curTime;
-    time(&curTime);
-    return (difftime(curTime,startTime)*(numIts-curIts))/curIts;
+    return (GetElapsedTime()*(numIts-curIts))/curIts;
   }
 }
 
@@ -52,3 +67,44 @@ void Timer::PrintRemainingTime() const{
   printf("%d remaining. Expected finish: %s",secs, ctime(&endtime));
   fflush(stdout);
 }
+
+unsigned Timer::AddSection(const std::string& name){
+  sectionNames.push_back(name);
+  sectionTimes.push_back(0);
+  sectionCalls.push_back(0);
+  return sectionNames.size()-1;
+}
+
+unsigned Timer::GetNumSections() const{
+  return sectionNames.size();
+}
+
+const std::string& Timer::GetSectionName(const unsigned section) const{
+  return sectionNames.at(section);
+}
+
+double Timer::GetSectionTime(const unsigned section) const{
+  return 1.e-9*sectionTimes.at(section);
+}
+
+unsigned long Timer::GetSectionCalls(const unsigned section) const{
+  return sectionCalls.at(section);
+}
+
+void Timer::PrintSections() const{
+  const double elapsed(GetElapsedTime());
+  double accounted(0.0);
+  printf("%-24s %16s %14s %14s %8s\n", "Section", "Calls", "Time [s]", "ns/call", "Percent");
+  for(unsigned section(0); section<sectionNames.size(); ++section){
+    const double seconds(GetSectionTime(section));
+    accounted+=seconds;
+    printf("%-24s %16lu %14.3f %14.1f %7.2f%%\n", sectionNames.at(section).c_str(),
+           sectionCalls.at(section), seconds,
+           sectionCalls.at(section)?1.e9*seconds/sectionCalls.at(section):0.0,
+           elapsed>0.0?100.0*seconds/elapsed:0.0);
+  }
+  printf("%-24s %16s %14.3f %14s %7.2f%%\n", "other", "", elapsed-accounted, "",
+         elapsed>0.0?100.0*(elapsed-accounted)/elapsed:0.0);
+  printf("%-24s %16s %14.3f\n", "total", "", elapsed);
+  fflush(stdout);
+}
@@ -0,0 +1,131 @@
+#include "trigger_index.hpp"
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <stdint.h>
+#include "cache_io.hpp"
+
+namespace{
+  std::size_t GetNumWords(const std::size_t num_bits){
+    return (num_bits+63)/64;
+  }
+}
+
+TriggerIndex::TriggerIndex():
+  patterns_(0),
+  single_pattern_triggers_(),
+  masks_(0),
+  positions_(0),
+  menu_(0),
+  menu_hash_(HashMenu(std::vector<std::string>())),
+  fired_(0){
+}
+
+std::size_t TriggerIndex::AddTrigger(const std::string& pattern){
+  std::size_t trigger(0);
+  if(FindTrigger(pattern, trigger)) return trigger;
+  trigger=AddTrigger(std::vector<std::string>(1, pattern));
+  single_pattern_triggers_[pattern]=trigger;
+  return trigger;
+}
+
+std::size_t TriggerIndex::AddTrigger(const std::vector<std::string>& patterns){
+  patterns_.push_back(patterns);
+  masks_.push_back(std::vector<uint64_t>());
+  positions_.push_back(std::vector<std::size_t>());
+  Resolve(patterns_.size()-1);
+  return patterns_.size()-1;
+}
+
+std::size_t TriggerIndex::GetNumTriggers() const{
+  return patterns_.size();
+}
+
+bool TriggerIndex::FindTrigger(const std::string& pattern, std::size_t& trigger) const{
+  const std::map<std::string, std::size_t>::const_iterator it(single_pattern_triggers_.find(pattern));
+  if(it==single_pattern_triggers_.end()) return false;
+  trigger=it->second;
+  return true;
+}
+
+bool TriggerIndex::SetMenu(const std::vector<std::string>& names){
+  //Returns true if the menu changed and the triggers were resolved again
+  const uint64_t hash(HashMenu(names));
+  if(hash==menu_hash_ && names.size()==menu_.size()) return false;
+  menu_=names;
+  menu_hash_=hash;
+  for(std::size_t trigger(0); trigger<patterns_.size(); ++trigger){
+    Resolve(trigger);
+  }
+  fired_.assign(GetNumWords(menu_.size()), 0);
+  return true;
+}
+
+uint64_t TriggerIndex::GetMenuHash() const{
+  return menu_hash_;
+}
+
+std::size_t TriggerIndex::GetMenuSize() const{
+  return menu_.size();
+}
+
+const std::vector<std::size_t>& TriggerIndex::GetMenuPositions(const std::size_t trigger) const{
+  return positions_.at(trigger);
+}
+
+void TriggerIndex::SetDecisions(const std::vector<float>& decisions,
+                                const std::vector<float>& prescales){
+  //A trigger counts as fired only if it passed and was not prescaled
+  fired_.assign(GetNumWords(menu_.size()), 0);
+  const std::size_t size(std::min(menu_.size(), std::min(decisions.size(), prescales.size())));
+  for(std::size_t position(0); position<size; ++position){
+    if(decisions[position]==1 && prescales[position]==1){
+      fired_[position/64] |= static_cast<uint64_t>(1) << (position%64);
+    }
+  }
+}
+
+bool TriggerIndex::Passes(const std::size_t trigger) const{
+  const std::vector<uint64_t>& mask(masks_.at(trigger));
+  for(std::size_t word(0); word<mask.size() && word<fired_.size(); ++word){
+    if(mask[word] & fired_[word]) return true;
+  }
+  return false;
+}
+
+uint64_t TriggerIndex::GetPassedMask() const{
+  //Bit i is set if trigger i passed; only the first max_mask_triggers triggers are included
+  uint64_t passed(0);
+  for(std::size_t trigger(0); trigger<patterns_.size() && trigger<max_mask_triggers; ++trigger){
+    if(Passes(trigger)) passed |= static_cast<uint64_t>(1) << trigger;
+  }
+  return passed;
+}
+
+uint64_t TriggerIndex::HashMenu(const std::vector<std::string>& names){
+  //Over the names, with a separator after each name
+  CacheHash hash;
+  for(std::size_t name(0); name<names.size(); ++name){
+    hash.Add(names[name]);
+    hash.AddByte(0xff);
+  }
+  return hash.Get();
+}
+
+void TriggerIndex::Resolve(const std::size_t trigger){
+  std::vector<uint64_t>& mask(masks_.at(trigger));
+  std::vector<std::size_t>& positions(positions_.at(trigger));
+  mask.assign(GetNumWords(menu_.size()), 0);
+  positions.clear();
+  const std::vector<std::string>& patterns(patterns_.at(trigger));
+  for(std::size_t position(0); position<menu_.size(); ++position){
+    for(std::size_t pattern(0); pattern<patterns.size(); ++pattern){
+      if(menu_[position].find(patterns[pattern])!=std::string::npos){
+        mask[position/64] |= static_cast<uint64_t>(1) << (position%64);
+        positions.push_back(position);
+        break;
+      }
+    }
+  }
+}
@@ -2,10 +2,12 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
 #include "TGraph.h"
 #include "TH1.h"
 #include "TH1D.h"
 #include "TChain.h"
+#include "yield_calculator.hpp"
 
 std::string fix_width(const long double number, const std::streamsize width){
   std::ostringstream oss("");
@@ -35,6 +37,23 @@ void get_count_and_uncertainty(TTree& tree,
   count=temp.IntegralAndError(1,1,uncertainty);
 }
 
+void get_counts_and_uncertainties(TTree& tree,
+                                  const std::vector<std::string>& cuts,
+                                  std::vector<double>& counts,
+                                  std::vector<double>& uncertainties){
+  //Same results as calling get_count_and_uncertainty once per cut, but reads the tree only once
+  YieldCalculator yields;
+  for(std::vector<std::string>::size_type cut(0); cut<cuts.size(); ++cut){
+    yields.AddRegion(cuts.at(cut), cuts.at(cut));
+  }
+  yields.Fill(tree);
+  counts.resize(cuts.size());
+  uncertainties.resize(cuts.size());
+  for(std::vector<std::string>::size_type cut(0); cut<cuts.size(); ++cut){
+    yields.GetCountAndUncertainty(cut, counts.at(cut), uncertainties.at(cut));
+  }
+}
+
 void add_point(TGraph& graph, const double x, const double y){
   graph.SetPoint(graph.GetN(), x, y);
 }
@@ -24,6 +24,11 @@ int main(int argc, char *argv[]){
         uint8_t utc_creation_second(0);
         int32_t utc_creation_isdst(0);
         uint32_t original_file_entries(0);
+        double wall_seconds(0.0), cpu_seconds(0.0), events_per_second(0.0);
+        ULong64_t bytes_read_compressed(0), bytes_read_uncompressed(0);
+        ULong64_t bytes_written(0), peak_rss_bytes(0);
+        uint32_t duplicate_events_skipped(0), uncertified_events_skipped(0);
+        bool sample_pileup_profile(false), measured_normalization(false);
 
         tree->SetBranchStatus("*",false);
         setup(*tree, "original_file_name", original_file_name);
@@ -36,6 +41,30 @@ int main(int argc, char *argv[]){
         setup(*tree, "utc_creation_minute", utc_creation_minute);
         setup(*tree, "utc_creation_second", utc_creation_second);
         setup(*tree, "utc_creation_isdst", utc_creation_isdst);
+        //Performance counters are only present in files made since they were added
+        const bool has_performance(tree->GetBranch("wall_seconds")!=NULL);
+        if(has_performance){
+          setup(*tree, "wall_seconds", wall_seconds);
+          setup(*tree, "cpu_seconds", cpu_seconds);
+          setup(*tree, "events_per_second", events_per_second);
+          setup(*tree, "bytes_read_compressed", bytes_read_compressed);
+          setup(*tree, "bytes_read_uncompressed", bytes_read_uncompressed);
+          setup(*tree, "bytes_written", bytes_written);
+          setup(*tree, "peak_rss_bytes", peak_rss_bytes);
+          setup(*tree, "duplicate_events_skipped", duplicate_events_skipped);
+        }
+        const bool has_uncertified(tree->GetBranch("uncertified_events_skipped")!=NULL);
+        if(has_uncertified){
+          setup(*tree, "uncertified_events_skipped", uncertified_events_skipped);
+        }
+        const bool has_pileup_profile(tree->GetBranch("sample_pileup_profile")!=NULL);
+        if(has_pileup_profile){
+          setup(*tree, "sample_pileup_profile", sample_pileup_profile);
+        }
+        const bool has_normalization(tree->GetBranch("measured_normalization")!=NULL);
+        if(has_normalization){
+          setup(*tree, "measured_normalization", measured_normalization);
+        }
 
         const int num_entries(tree->GetEntries());
         if(num_entries>0){
@@ -59,7 +88,27 @@ int main(int argc, char *argv[]){
                     << "    cfA n-tuple file: " << *original_file_name << '\n'
                     << "reduced_tree version: " << reduced_tree_version << '\n'
                     << "            Produced: " << time_string
-                    << " cfA n-tuple entries: " << original_file_entries << '\n' << std::endl;
+                    << " cfA n-tuple entries: " << original_file_entries << '\n';
+          if(has_performance){
+            std::cout << "        Wall seconds: " << wall_seconds << '\n'
+                      << "         CPU seconds: " << cpu_seconds << '\n'
+                      << "   Events per second: " << events_per_second << '\n'
+                      << "Bytes read (on disk): " << bytes_read_compressed << '\n'
+                      << "Bytes read (in mem.): " << bytes_read_uncompressed << '\n'
+                      << "       Bytes written: " << bytes_written << '\n'
+                      << "      Peak RSS bytes: " << peak_rss_bytes << '\n'
+                      << "  Duplicates skipped: " << duplicate_events_skipped << '\n';
+          }
+          if(has_uncertified){
+            std::cout << " Uncertified skipped: " << uncertified_events_skipped << '\n';
+          }
+          if(has_pileup_profile){
+            std::cout << "      Pileup profile: " << (sample_pileup_profile?"sample":"Summer2012_S10") << '\n';
+          }
+          if(has_normalization){
+            std::cout << "       Normalization: " << (measured_normalization?"measured":"table") << '\n';
+          }
+          std::cout << std::endl;
         }else{
           std::cerr << "Error: tree meta_info has no entries in file " << argv[arg] << '.' << std::endl;
         }
@@ -0,0 +1,140 @@
+#include "weighted_histogram.hpp"
+#include <cmath>
+#include <vector>
+#include <string>
+#include <iostream>
+#include "TH1D.h"
+
+namespace{
+  //Doubles per 64 byte cache line
+  const std::size_t line_size(8);
+}
+
+WeightedHistogram::WeightedHistogram(const unsigned num_bins,
+                                     const double low,
+                                     const double high,
+                                     const std::size_t num_slots):
+  num_bins_(num_bins),
+  low_(low),
+  high_(high),
+  scale_(num_bins/(high-low)),
+  num_slots_(num_slots>0?num_slots:1),
+  //Interleaved sumw and sumw2 for every bin, then the number of entries, rounded
+  //up to whole cache lines plus one spare line since the buffer itself need not
+  //be aligned
+  stride_(((2*(num_bins+2)+1+line_size-1)/line_size+1)*line_size),
+  entries_offset_(2*(num_bins+2)),
+  slots_(num_slots_*stride_, 0.0),
+  sumw_(num_bins+2, 0.0),
+  sumw2_(num_bins+2, 0.0),
+  entries_(0.0){
+}
+
+unsigned WeightedHistogram::GetNumBins() const{
+  return num_bins_;
+}
+
+double WeightedHistogram::GetLow() const{
+  return low_;
+}
+
+double WeightedHistogram::GetHigh() const{
+  return high_;
+}
+
+std::size_t WeightedHistogram::GetNumSlots() const{
+  return num_slots_;
+}
+
+void WeightedHistogram::Fill(const std::size_t slot, const double* const x, const double* const w,
+                             const std::size_t num_values){
+  double* const sums(&slots_.at(slot*stride_));
+  std::size_t num_filled(0);
+  for(std::size_t i(0); i<num_values; ++i){
+    if(w[i]==0.0 || x[i]!=x[i]) continue;
+    const unsigned bin(FindBin(x[i]));
+    sums[2*bin]+=w[i];
+    sums[2*bin+1]+=w[i]*w[i];
+    ++num_filled;
+  }
+  sums[entries_offset_]+=num_filled;
+}
+
+void WeightedHistogram::Merge(){
+  for(std::size_t slot(0); slot<num_slots_; ++slot){
+    double* const sums(&slots_.at(slot*stride_));
+    for(unsigned bin(0); bin<sumw_.size(); ++bin){
+      sumw_.at(bin)+=sums[2*bin];
+      sumw2_.at(bin)+=sums[2*bin+1];
+    }
+    entries_+=sums[entries_offset_];
+  }
+  slots_.assign(slots_.size(), 0.0);
+}
+
+bool WeightedHistogram::Add(const WeightedHistogram& other){
+  //Adds the merged totals of other; call Merge on both first
+  if(other.num_bins_!=num_bins_ || other.low_!=low_ || other.high_!=high_){
+    std::cerr << "Error: Cannot add histograms with different binning." << std::endl;
+    return false;
+  }
+  for(unsigned bin(0); bin<sumw_.size(); ++bin){
+    sumw_.at(bin)+=other.sumw_.at(bin);
+    sumw2_.at(bin)+=other.sumw2_.at(bin);
+  }
+  entries_+=other.entries_;
+  return true;
+}
+
+void WeightedHistogram::Reset(){
+  slots_.assign(slots_.size(), 0.0);
+  sumw_.assign(sumw_.size(), 0.0);
+  sumw2_.assign(sumw2_.size(), 0.0);
+  entries_=0.0;
+}
+
+double WeightedHistogram::GetSumW(const unsigned bin) const{
+  return sumw_.at(bin);
+}
+
+double WeightedHistogram::GetSumW2(const unsigned bin) const{
+  return sumw2_.at(bin);
+}
+
+double WeightedHistogram::GetError(const unsigned bin) const{
+  return sqrt(sumw2_.at(bin));
+}
+
+double WeightedHistogram::GetEntries() const{
+  return entries_;
+}
+
+double WeightedHistogram::GetIntegral() const{
+  //Visible bins only, like TH1::Integral
+  double integral(0.0);
+  for(unsigned bin(1); bin<=num_bins_; ++bin){
+    integral+=sumw_.at(bin);
+  }
+  return integral;
+}
+
+TH1D WeightedHistogram::GetTH1D(const std::string& name, const std::string& title) const{
+  TH1D histo(name.c_str(), title.c_str(), num_bins_, low_, high_);
+  histo.Sumw2();
+  CopyTo(histo);
+  return histo;
+}
+
+bool WeightedHistogram::CopyTo(TH1D& histo) const{
+  if(static_cast<unsigned>(histo.GetNbinsX())!=num_bins_){
+    std::cerr << "Error: " << histo.GetName() << " has " << histo.GetNbinsX()
+              << " bins instead of " << num_bins_ << '.' << std::endl;
+    return false;
+  }
+  for(unsigned bin(0); bin<sumw_.size(); ++bin){
+    histo.SetBinContent(bin, sumw_.at(bin));
+    histo.SetBinError(bin, sqrt(sumw2_.at(bin)));
+  }
+  histo.SetEntries(entries_);
+  return true;
+}
@@ -0,0 +1,161 @@
+#include "yield_calculator.hpp"
+#include <cmath>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include "TTree.h"
+#include "TTreeFormula.h"
+#include "columnar_file.hpp"
+#include "cut_expression.hpp"
+
+YieldCalculator::YieldCalculator(const std::string& default_weight):
+  default_weight_(default_weight),
+  regions_(0),
+  expressions_(0){
+}
+
+std::size_t YieldCalculator::AddExpression(const std::string& expression){
+  const std::vector<std::string>::const_iterator it(std::find(expressions_.begin(), expressions_.end(), expression));
+  if(it!=expressions_.end()){
+    return it-expressions_.begin();
+  }else{
+    expressions_.push_back(expression);
+    return expressions_.size()-1;
+  }
+}
+
+std::size_t YieldCalculator::AddRegion(const std::string& name,
+                                       const std::string& cut,
+                                       const std::string& weight){
+  Region region;
+  region.name=name;
+  region.cut=AddExpression(cut==""?"1":cut);
+  region.weight=AddExpression(weight==""?default_weight_:weight);
+  region.sumw=0.0;
+  region.sumw2=0.0;
+  regions_.push_back(region);
+  return regions_.size()-1;
+}
+
+std::size_t YieldCalculator::GetNumRegions() const{
+  return regions_.size();
+}
+
+const std::string& YieldCalculator::GetName(const std::size_t region) const{
+  return regions_.at(region).name;
+}
+
+void YieldCalculator::Reset(){
+  for(std::vector<Region>::iterator region(regions_.begin());
+      region!=regions_.end(); ++region){
+    region->sumw=0.0;
+    region->sumw2=0.0;
+  }
+}
+
+void YieldCalculator::Fill(TTree& tree){
+  std::vector<TTreeFormula*> formulas(expressions_.size(), static_cast<TTreeFormula*>(NULL));
+  for(std::size_t i(0); i<expressions_.size(); ++i){
+    std::ostringstream name("");
+    name << "yield_calculator_" << i;
+    formulas.at(i)=new TTreeFormula(name.str().c_str(), expressions_.at(i).c_str(), &tree);
+  }
+
+  //Values are computed lazily so that an expression shared by several regions
+  //(typically the weight) is evaluated at most once per event
+  std::vector<double> values(expressions_.size(), 0.0);
+  std::vector<bool> evaluated(expressions_.size(), false);
+  int tree_number(-1);
+  const Long64_t num_entries(tree.GetEntries());
+  for(Long64_t entry(0); entry<num_entries; ++entry){
+    if(tree.LoadTree(entry)<0) break;
+    if(tree.GetTreeNumber()!=tree_number){
+      tree_number=tree.GetTreeNumber();
+      for(std::size_t i(0); i<formulas.size(); ++i){
+        formulas.at(i)->UpdateFormulaLeaves();
+      }
+    }
+    std::fill(evaluated.begin(), evaluated.end(), false);
+    for(std::vector<Region>::iterator region(regions_.begin());
+        region!=regions_.end(); ++region){
+      const std::size_t indices[2]={region->cut, region->weight};
+      double value(1.0);
+      for(unsigned j(0); j<2 && value!=0.0; ++j){
+        const std::size_t index(indices[j]);
+        if(!evaluated.at(index)){
+          formulas.at(index)->GetNdata();
+          values.at(index)=formulas.at(index)->EvalInstance(0);
+          evaluated.at(index)=true;
+        }
+        value*=values.at(index);
+      }
+      if(value!=0.0){
+        region->sumw+=value;
+        region->sumw2+=value*value;
+      }
+    }
+  }
+
+  for(std::size_t i(0); i<formulas.size(); ++i){
+    delete formulas.at(i);
+  }
+}
+
+bool YieldCalculator::Fill(const ColumnarFile& file){
+  std::vector<CutExpression> expressions;
+  expressions.reserve(expressions_.size());
+  for(std::size_t i(0); i<expressions_.size(); ++i){
+    expressions.push_back(CutExpression(expressions_.at(i)));
+    if(!expressions.back().Bind(file)){
+      std::cerr << expressions.back().GetError() << std::endl;
+      return false;
+    }
+  }
+
+  std::vector<const double*> values(expressions.size(), static_cast<const double*>(NULL));
+  const uint64_t num_entries(file.GetNumEntries());
+  for(uint64_t first(0); first<num_entries; first+=CutExpression::batch_size){
+    const std::size_t batch(num_entries-first<CutExpression::batch_size
+                            ?num_entries-first:CutExpression::batch_size);
+    for(std::size_t i(0); i<expressions.size(); ++i){
+      values.at(i)=expressions.at(i).Evaluate(first, batch);
+    }
+    for(std::vector<Region>::iterator region(regions_.begin());
+        region!=regions_.end(); ++region){
+      const double* const cut(values.at(region->cut));
+      const double* const weight(values.at(region->weight));
+      double sumw(0.0), sumw2(0.0);
+      for(std::size_t entry(0); entry<batch; ++entry){
+        const double value(cut[entry]*weight[entry]);
+        sumw+=value;
+        sumw2+=value*value;
+      }
+      region->sumw+=sumw;
+      region->sumw2+=sumw2;
+    }
+  }
+  return true;
+}
+
+void YieldCalculator::GetCountAndUncertainty(const std::size_t region,
+                                             double& count,
+                                             double& uncertainty) const{
+  count=regions_.at(region).sumw;
+  uncertainty=sqrt(regions_.at(region).sumw2);
+}
+
+bool YieldCalculator::GetCountAndUncertainty(const std::string& name,
+                                             double& count,
+                                             double& uncertainty) const{
+  for(std::size_t region(0); region<regions_.size(); ++region){
+    if(regions_.at(region).name==name){
+      GetCountAndUncertainty(region, count, uncertainty);
+      return true;
+    }
+  }
+  count=0.0;
+  uncertainty=0.0;
+  return false;
+}